@@ -28,12 +28,12 @@ class ChLoadAddedMass : public chrono::ChLoadCustomMultiple {
      * system. Also need to be separate from any bodies without hydro forces (or added mass) and hydro bodies need to be
      * added to system before any bodies without hydro forces applied.
      *
-     * @param body_info_struct HydroData::BodyInfo for each body with h5 information including added mass matrix
+     * @param hydro_data shared h5 data for each body including added mass matrix, referenced not copied
      * @param bodies vector of Project Chrono bodies to apply added mass to. Must be added to system in same order as in
      * this matrix.
      * @param system pointer to system containing the bodies, used for getting system mass matrix size at any time.
      */
-    ChLoadAddedMass(const std::vector<HydroData::BodyInfo>& body_info_struct,
+    ChLoadAddedMass(std::shared_ptr<const HydroData> hydro_data,
                     std::vector<std::shared_ptr<ChLoadable>>& bodies,
                     ChSystem* system);
 
@@ -90,9 +90,17 @@ class ChLoadAddedMass : public chrono::ChLoadCustomMultiple {
 
   private:
     ChSystem* system;
-    ChMatrixDynamic<double> infinite_added_mass;  ///< added mass at infinite frequency in global coordinates
+    std::shared_ptr<const HydroData> hydro_data_;  ///< h5 data holding the per body added mass rows
+    int num_bodies_;                               ///< number of hydro bodies (first 6N rows of the system matrix)
     ChMatrixDynamic<double>
         infinite_added_mass_system;  ///< added mass at infinite frequency in global coordinates (system matrix)
+
+    /**
+     * @brief Sizes the system added mass matrix and copies the infinite added mass of the hydro bodies into it.
+     *
+     * @param size number of rows (and columns) of the system mass matrix, at least 6N
+     */
+    void AssembleSystemMatrix(int size);
     virtual bool IsStiff() override { return true; }  // this to force the use of the inertial M, R and K matrices
 };
 
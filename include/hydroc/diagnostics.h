@@ -0,0 +1,135 @@
+#ifndef DIAGNOSTICS_H
+#define DIAGNOSTICS_H
+/*********************************************************************
+ * @file  diagnostics.h
+ *
+ * @brief header file of the diagnostics sinks, destinations of the \
+ * series written during the wave setup (spectrum, free surface elevation).
+ *********************************************************************/
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Destination of the diagnostic series written during the setup of the waves.
+ *
+ * Writing diagnostics never stops the simulation: sinks report failures on std::cerr instead of throwing.
+ */
+class DiagnosticsSink {
+  public:
+    virtual ~DiagnosticsSink() = default;
+
+    /**
+     * @brief Writes a named series of (x, y) pairs, e.g. "eta" with the times and the free surface elevation.
+     *
+     * @param name name of the series
+     * @param x first column
+     * @param y second column, same size as x
+     */
+    virtual void WriteSeries(const std::string& name, const std::vector<double>& x, const std::vector<double>& y) = 0;
+
+    /**
+     * @brief Returns once all series written so far are stored.
+     */
+    virtual void Flush() {}
+};
+
+/**
+ * @brief Discards all diagnostics.
+ */
+class NullDiagnosticsSink : public DiagnosticsSink {
+  public:
+    void WriteSeries(const std::string&, const std::vector<double>&, const std::vector<double>&) override {}
+};
+
+/**
+ * @brief Writes each series to <directory>/<name>.txt as "x : y" lines (the eta file text format, see ReadEtaFile()).
+ *
+ * The default sink of IrregularWaves writes to the working directory (spectral_densities.txt and eta.txt), give each
+ * run its own directory when several cases run in parallel.
+ */
+class TextDiagnosticsSink : public DiagnosticsSink {
+  public:
+    /**
+     * @brief Writes to the given directory, created on the first write if it does not exist yet.
+     *
+     * @param directory output directory
+     */
+    explicit TextDiagnosticsSink(std::string directory = ".");
+
+    void WriteSeries(const std::string& name, const std::vector<double>& x, const std::vector<double>& y) override;
+
+  private:
+    std::string directory_;
+};
+
+/**
+ * @brief Writes each series as a N x 2 dataset <group>/<name> of an HDF5 file.
+ *
+ * The file is created if it does not exist, series already in the group are replaced.
+ */
+class HDF5DiagnosticsSink : public DiagnosticsSink {
+  public:
+    /**
+     * @param file_name HDF5 file
+     * @param group group of the datasets, e.g. "run_12/waves", "/" for the root
+     */
+    HDF5DiagnosticsSink(std::string file_name, std::string group = "/");
+
+    void WriteSeries(const std::string& name, const std::vector<double>& x, const std::vector<double>& y) override;
+
+  private:
+    std::string file_name_;
+    std::string group_;
+};
+
+/**
+ * @brief Hands the series to another sink on a background thread, so the setup does not wait for the file I/O.
+ *
+ * WriteSeries() copies the series and returns. The series are written in order. Flush() has the background thread
+ * flush the sink after the series written before, and waits for it. The destructor writes the pending series before
+ * returning.
+ */
+class AsyncDiagnosticsSink : public DiagnosticsSink {
+  public:
+    /**
+     * @param sink sink that stores the series, only used from the background thread
+     */
+    explicit AsyncDiagnosticsSink(std::shared_ptr<DiagnosticsSink> sink);
+    ~AsyncDiagnosticsSink() override;
+
+    AsyncDiagnosticsSink(const AsyncDiagnosticsSink&) = delete;
+    AsyncDiagnosticsSink& operator=(const AsyncDiagnosticsSink&) = delete;
+
+    void WriteSeries(const std::string& name, const std::vector<double>& x, const std::vector<double>& y) override;
+    void Flush() override;
+
+  private:
+    // a series to write, or a flush of the sink
+    struct Series {
+        std::string name;
+        std::vector<double> x;
+        std::vector<double> y;
+        bool flush;
+    };
+
+    std::shared_ptr<DiagnosticsSink> sink_;
+    std::mutex mutex_;
+    std::condition_variable queue_changed_;
+    std::deque<Series> queue_;
+    // Flush() calls queued and done by the worker
+    size_t num_flushes_requested_ = 0;
+    size_t num_flushes_done_      = 0;
+    bool stop_                    = false;
+    std::thread worker_;
+
+    void Run();
+};
+
+#endif
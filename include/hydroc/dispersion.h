@@ -0,0 +1,96 @@
+#ifndef DISPERSION_H
+#define DISPERSION_H
+/*********************************************************************
+ * @file  dispersion.h
+ *
+ * @brief header file of DispersionSolver, wave numbers of the linear \
+ * dispersion relation for a water depth.
+ *********************************************************************/
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Dense>
+
+/**
+ * @brief Solves the linear dispersion relation omega^2 = g k tanh(k d) for the wave number k at a water depth d.
+ *
+ * Newton iterations on the dimensionless relation x tanh(x) = omega^2 d / g (x = k d) start from the explicit
+ * approximation of Fenton and McKee (1990), x = (omega^2 d / g) coth^(2/3)((omega^2 d / g)^(3/4)), which is within
+ * about 2% everywhere, so 2-3 iterations reach machine precision.
+ *
+ * Solved frequencies are kept in a small sorted table, so repeated solves of the same frequencies (many wave instances
+ * of one spectrum) are binary searches. The table is bounded, larger batches are solved again. Get() shares one
+ * solver, with its table, per water depth.
+ *
+ * All methods are thread safe.
+ */
+class DispersionSolver {
+  public:
+    /**
+     * @brief Sets up a solver for a water depth.
+     *
+     * @param water_depth water depth (m)
+     * @param g gravitational acceleration (m/s^2)
+     *
+     * @exception std::runtime_error if the water depth or g is not positive
+     */
+    DispersionSolver(double water_depth, double g);
+
+    /**
+     * @brief Gets the solver shared by all callers for a water depth and g, created on the first call.
+     *
+     * @param water_depth water depth (m)
+     * @param g gravitational acceleration (m/s^2)
+     *
+     * @return shared solver
+     *
+     * @exception std::runtime_error if the water depth or g is not positive
+     */
+    static std::shared_ptr<const DispersionSolver> Get(double water_depth, double g);
+
+    /**
+     * @brief Computes the wave number of a wave frequency.
+     *
+     * @param omega wave frequency (rad/s)
+     *
+     * @return wave number (rad/m), 0 for omega = 0
+     */
+    double GetWaveNumber(double omega) const;
+
+    /**
+     * @brief Computes the wave numbers of a batch of wave frequencies.
+     *
+     * @param omegas wave frequencies (rad/s)
+     * @param num_threads threads solving the frequencies that are not in the table, 0 for all hardware threads
+     *
+     * @return wave number (rad/m) of each frequency
+     */
+    Eigen::VectorXd GetWaveNumbers(const Eigen::VectorXd& omegas, int num_threads = 1) const;
+
+    double GetWaterDepth() const { return water_depth_; }
+
+  private:
+    double water_depth_;
+    double g_;
+    // (omega, wave number) of the solved frequencies sorted by omega, cleared when it reaches kMaxTableSize entries
+    using TableEntry                      = std::pair<double, double>;
+    static constexpr size_t kMaxTableSize = 4096;
+    mutable std::vector<TableEntry> table_;
+    mutable std::mutex table_mutex_;
+
+    /**
+     * @brief Solves the dispersion relation for frequencies that are not in the table.
+     *
+     * @param omegas wave frequencies (rad/s)
+     * @param num_threads threads solving the frequencies, 0 for all hardware threads
+     *
+     * @return wave numbers (rad/m)
+     */
+    Eigen::ArrayXd Solve(const Eigen::ArrayXd& omegas, int num_threads) const;
+};
+
+#endif
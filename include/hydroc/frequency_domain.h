@@ -0,0 +1,112 @@
+#ifndef FREQUENCY_DOMAIN_H
+#define FREQUENCY_DOMAIN_H
+/*********************************************************************
+ * @file  frequency_domain.h
+ *
+ * @brief header file of FrequencyDomainSolver, linear frequency domain \
+ * response (RAO) of hydro bodies from the h5 hydro data.
+ *********************************************************************/
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <Eigen/Dense>
+#include <hydroc/h5fileinfo.h>
+#include <hydroc/wave_types.h>
+
+/**
+ * @brief Results of FrequencyDomainSolver::Solve() for a batch of wave frequencies.
+ */
+struct FrequencyDomainResults {
+    /// @brief wave frequencies (rad/s)
+    Eigen::VectorXd omegas;
+    /// @brief complex body response per unit wave amplitude (RAO), 6N x number of frequencies
+    ///
+    /// Same convention as RegularWave: the motion of dof i at frequency k is |response(i, k)| * A *
+    /// cos(omega_k * t + arg(response(i, k))) for a wave of amplitude A.
+    Eigen::MatrixXcd response;
+    /// @brief mean power absorbed by the PTO per unit wave amplitude squared (W/m^2), one value per frequency
+    Eigen::VectorXd pto_power;
+};
+
+/**
+ * @brief Linear frequency domain solver for the coupled response of the hydro bodies in regular waves.
+ *
+ * Solves [-omega^2 (M + A(omega)) + i omega (B(omega) + B_pto) + (K_hs + K_pto)] X = F_ex(omega) for each frequency,
+ * with the frequency dependent added mass A, radiation damping B, excitation F_ex (magnitude and phase) and hydrostatic
+ * stiffness K_hs from the h5 file. Coefficients are linearly interpolated between the h5 frequencies, and the
+ * excitation between the h5 headings, the same way RegularWave interpolates the excitation.
+ *
+ * Gives the steady state response of a regular wave simulation (e.g. demo_sphere_reg_waves) without time stepping.
+ */
+class FrequencyDomainSolver {
+  public:
+    /**
+     * @brief Sets up the solver for the bodies in the hydro data.
+     *
+     * @param hydro_data shared h5 data, needs the frequency dependent added mass and radiation damping (see
+     * HydroData::HasFrequencyDependentRadiation())
+     * @param mass_matrix 6N x 6N rigid body mass matrix (mass and inertia of each body about its center of gravity)
+     *
+     * @exception std::runtime_error if the hydro data has no frequency dependent radiation or the mass matrix size is
+     * wrong
+     */
+    FrequencyDomainSolver(std::shared_ptr<const HydroData> hydro_data, const Eigen::MatrixXd& mass_matrix);
+
+    /**
+     * @brief Sets the linear PTO acting on the bodies (zero by default).
+     *
+     * @param damping 6N x 6N PTO damping matrix, absorbs power
+     * @param stiffness 6N x 6N PTO stiffness matrix
+     */
+    void SetPTO(const Eigen::MatrixXd& damping, const Eigen::MatrixXd& stiffness);
+
+    /**
+     * @brief Restricts the motion to some degrees of freedom, the other ones are fixed (all free by default).
+     *
+     * Equivalent to joints to the ground in the time domain, e.g. {2} for a body in heave only.
+     *
+     * @param dofs indices (0,...,6N-1) of the free degrees of freedom
+     */
+    void SetActiveDofs(const std::vector<int>& dofs);
+
+    /**
+     * @brief Computes the response and PTO power for a batch of wave frequencies.
+     *
+     * @param omegas wave frequencies (rad/s), within the frequency range of the h5 data
+     * @param wave_heading wave heading (degrees), the excitation is interpolated between the h5 headings as in
+     * RegularWave (see RegularWave::regular_wave_heading_)
+     *
+     * @return response per unit wave amplitude and PTO power per unit wave amplitude squared
+     *
+     * @exception std::runtime_error if the wave heading is outside of the h5 headings
+     */
+    FrequencyDomainResults Solve(const Eigen::VectorXd& omegas, double wave_heading = 0.0) const;
+
+  private:
+    std::shared_ptr<const HydroData> hydro_data_;
+    int num_dofs_;
+    Eigen::MatrixXd mass_matrix_;
+    Eigen::MatrixXd hydrostatic_stiffness_;
+    Eigen::MatrixXd pto_damping_;
+    Eigen::MatrixXd pto_stiffness_;
+    std::vector<int> active_dofs_;
+
+    /**
+     * @brief Interpolates the radiation and excitation coefficients of all bodies at a frequency.
+     *
+     * @param[in] omega wave frequency (rad/s)
+     * @param[in] heading h5 headings around the wave heading (see GetHeadingInterp())
+     * @param[out] added_mass 6N x 6N added mass matrix
+     * @param[out] damping 6N x 6N radiation damping matrix
+     * @param[out] excitation 6N complex excitation force per unit wave amplitude
+     */
+    void InterpolateCoefficients(double omega,
+                                 const HeadingInterp& heading,
+                                 Eigen::MatrixXd& added_mass,
+                                 Eigen::MatrixXd& damping,
+                                 Eigen::VectorXcd& excitation) const;
+};
+
+#endif
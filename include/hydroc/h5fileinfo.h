@@ -10,7 +10,10 @@
 #pragma once
 
 #include <limits>
-#include <optional>
+#include <map>
+#include <memory>
+#include <future>
+#include <mutex>
 #include <string>
 #include <variant>
 #include <vector>
@@ -31,27 +34,94 @@ class H5FileInfo;
 
 // TODO separate these 2 classes into 2 files? (and corresponding .cpp)
 
+/**
+ * @brief Linear interpolation table over the BEM frequency list, which does not have to be uniform.
+ *
+ * Built once when the h5 data is loaded and shared by everything interpolating frequency dependent coefficients
+ * (RegularWave, FrequencyDomainSolver). Lookups are O(1) on uniform frequency lists and O(log n) otherwise.
+ */
+class FrequencyTable {
+  public:
+    /**
+     * @brief Position of a frequency in the table: value(omega) = (1 - weight) * value[index] + weight *
+     * value[index + 1].
+     *
+     * weight is 0 (and index + 1 is not used) when omega is the last frequency or the table has a single frequency.
+     */
+    struct Interp {
+        int index;
+        double weight;
+    };
+
+    FrequencyTable() = default;
+
+    /**
+     * @brief Builds the table.
+     *
+     * @param omegas frequencies (rad/s) in increasing order
+     *
+     * @exception std::runtime_error if the frequencies are empty or not increasing
+     */
+    explicit FrequencyTable(const Eigen::VectorXd& omegas);
+
+    /**
+     * @brief Finds the frequencies around omega.
+     *
+     * @param omega frequency (rad/s)
+     *
+     * @return lower index and weight of the upper frequency
+     *
+     * @exception std::runtime_error if omega is outside of the table
+     */
+    Interp Lookup(double omega) const;
+
+    /**
+     * @brief Gets the frequencies of the table.
+     *
+     * @return frequencies (rad/s)
+     */
+    const Eigen::VectorXd& GetFrequencies() const { return omegas_; }
+
+  private:
+    Eigen::VectorXd omegas_;
+    // uniform spacing, or 0 if the frequencies are not uniform
+    double uniform_delta_ = 0.0;
+};
+
 // contains "chunked" data from the h5 file, generated from H5FileInfor class
+// once loaded, HydroData is meant to be shared read-only (std::shared_ptr<const HydroData>) between TestHydro,
+// wave classes and ChLoadAddedMass, which reference its data instead of copying it
 class HydroData {
   public:
     struct BodyInfo {
         std::string body_name;
-        int body_num;
+        int body_num;  // 0 indexed body number in the h5 file (body_name is "body" + (body_num + 1))
         double disp_vol;
         Eigen::VectorXd rirf_time_vector;
         double rirf_timestep;
         Eigen::VectorXd cg;
         Eigen::VectorXd cb;
-        Eigen::MatrixXd lin_matrix;
-        Eigen::MatrixXd inf_added_mass;
-        Eigen::Tensor<double, 3> rirf_matrix;
-        // Eigen::Tensor<double, 3> radiation_damping_matrix;
+        // the coefficients below are shared between bodies with identical data (e.g. identical devices in a farm),
+        // see HydroData::ShareIdenticalCoefficients()
+        std::shared_ptr<const Eigen::MatrixXd> lin_matrix;
+        // 6 x 6 blocks of this body's rows of the infinite frequency added mass, one block per (column) body
+        std::vector<std::shared_ptr<const Eigen::MatrixXd>> inf_added_mass_blocks;
+        // 6 x 6 x T blocks of this body's rows of the RIRF, one block per (column) body
+        std::vector<std::shared_ptr<const Eigen::Tensor<double, 3>>> rirf_blocks;
+        // 6 x 6 x F blocks of this body's rows of the frequency dependent added mass (scaled by rho) and radiation
+        // damping (scaled by rho * omega), one block per (column) body, at the frequencies of
+        // RegularWaveInfo::freq_list, empty if the h5 file has no frequency dependent radiation coefficients
+        std::vector<std::shared_ptr<const Eigen::Tensor<double, 3>>> added_mass_blocks;
+        std::vector<std::shared_ptr<const Eigen::Tensor<double, 3>>> radiation_damping_blocks;
     };
     struct SimulationParameters {
         std::string h5_file_name;
         double rho;
         double g;
         double water_depth;
+        // wave headings (degrees) of the excitation coefficients, the second dimension of
+        // RegularWaveInfo::excitation_mag_matrix
+        Eigen::VectorXd wave_headings;
     };
     struct RegularWaveInfo {
         Eigen::VectorXd freq_list;
@@ -63,12 +133,18 @@ class HydroData {
         // Eigen::Vector3i re_dims;
         // Eigen::Tensor<double, 3> excitation_im_matrix;
         // Eigen::Vector3i im_dims;
+        // resampled to a uniform time step by GetResampledExcitationIRF(), set with SetExcitationIRF()
         Eigen::VectorXd excitation_irf_time;
-        Eigen::MatrixXd excitation_irf_matrix;  // TODO needs to be tensor?
-
-        // see std::optional documentation for how to use
-        std::optional<Eigen::MatrixXd> excitation_irf_resampled;  // TODO needs to be tensor?
-        std::optional<Eigen::MatrixXd> excitation_irf_time_resampled;
+        std::shared_ptr<const Eigen::MatrixXd> excitation_irf_matrix;  // TODO needs to be tensor?
+    };
+    // excitation IRF of a body resampled to a uniform time step, see GetResampledExcitationIRF()
+    struct ResampledExcitationIRF {
+        std::shared_ptr<const Eigen::VectorXd> time;
+        std::shared_ptr<const Eigen::MatrixXd> values;
+        // trapezoidal integration width of each time value
+        Eigen::VectorXd widths;
+        // values with the widths folded in (values * diag(widths)), the convolution weights of each time value
+        std::shared_ptr<const Eigen::MatrixXd> weighted;
     };
 
   private:
@@ -82,8 +158,48 @@ class HydroData {
     // a vector of IrregularWaveInfo, one for each hydro body in system
     // is empty if irregular waves are not used
     std::vector<IrregularWaveInfo> irreg_wave_data_;
+    // interpolation table over RegularWaveInfo::freq_list (the same for every body)
+    FrequencyTable frequency_table_;
+    // GetResampledExcitationIRF() results per (body with the source IRF, dt), each computed once by the first caller
+    // while later callers wait on its future. A copy of the data shares the entries, the cache is cleared when the
+    // IRFs are modified (entries already returned stay valid)
+    struct ExcitationIRFCache {
+        using Entry = std::shared_future<std::shared_ptr<const ResampledExcitationIRF>>;
+        ExcitationIRFCache() = default;
+        ExcitationIRFCache(const ExcitationIRFCache& other) : entries(other.GetEntries()) {}
+        ExcitationIRFCache& operator=(const ExcitationIRFCache& other) {
+            if (this != &other) {
+                auto copied = other.GetEntries();
+                std::lock_guard<std::mutex> lock(mutex);
+                entries = std::move(copied);
+            }
+            return *this;
+        }
+        std::map<std::pair<size_t, double>, Entry> GetEntries() const {
+            std::lock_guard<std::mutex> lock(mutex);
+            return entries;
+        }
+        void Clear() {
+            std::lock_guard<std::mutex> lock(mutex);
+            entries.clear();
+        }
+        mutable std::mutex mutex;
+        std::map<std::pair<size_t, double>, Entry> entries;
+    };
+    mutable ExcitationIRFCache excitation_irf_cache_;
     friend H5FileInfo;
+    friend class HydroDataCache;
     void resize(int num_bodies);
+    Eigen::MatrixXd GetFrequencyDependentMatrix(
+        const std::vector<std::shared_ptr<const Eigen::Tensor<double, 3>>>& blocks,
+        int freq_index) const;
+    // first body with the same excitation IRF as body (itself if none), the key of its resampled IRF
+    size_t GetExcitationIRFSource(int body) const;
+    // adds a resampled IRF (e.g. read back by the HydroDataCache) to the GetResampledExcitationIRF() cache
+    void AddResampledExcitationIRF(int body,
+                                   double dt,
+                                   std::shared_ptr<const Eigen::VectorXd> time,
+                                   std::shared_ptr<const Eigen::MatrixXd> values);
     HydroData() = default;
 
   public:
@@ -97,10 +213,48 @@ class HydroData {
      *
      * @param b body number, 0 indexed
      *
-     * @return added mass matrix for the body from h5file
+     * @return added mass matrix (6 x 6N) for the body from h5file, assembled from the shared blocks
      */
     Eigen::MatrixXd GetInfAddedMassMatrix(int b) const;
 
+    /**
+     * @brief returns the frequency dependent added mass matrix for the given body and frequency.
+     *
+     * Matrix is scaled by rho when initialized, does not need to be scaled here.
+     *
+     * @param b body number, 0 indexed
+     * @param freq_index index of the frequency in RegularWaveInfo::freq_list
+     *
+     * @return added mass matrix (6 x 6N) for the body at the frequency
+     */
+    Eigen::MatrixXd GetAddedMassMatrix(int b, int freq_index) const;
+
+    /**
+     * @brief returns the frequency dependent radiation damping matrix for the given body and frequency.
+     *
+     * Matrix is scaled by rho * omega when initialized, does not need to be scaled here.
+     *
+     * @param b body number, 0 indexed
+     * @param freq_index index of the frequency in RegularWaveInfo::freq_list
+     *
+     * @return radiation damping matrix (6 x 6N) for the body at the frequency
+     */
+    Eigen::MatrixXd GetRadiationDampingMatrix(int b, int freq_index) const;
+
+    /**
+     * @brief Gets the interpolation table over the h5 frequencies (RegularWaveInfo::freq_list).
+     *
+     * @return frequency table shared by all bodies
+     */
+    const FrequencyTable& GetFrequencyTable() const { return frequency_table_; }
+
+    /**
+     * @brief Checks if the frequency dependent added mass and radiation damping were read for all bodies.
+     *
+     * @return true if the h5 file contains added_mass/all and radiation_damping/all for every body
+     */
+    bool HasFrequencyDependentRadiation() const;
+
     /**
      * @brief Get specific value of the linear restoring stiffness matrix for body b, row i , column j.
      *
@@ -119,7 +273,7 @@ class HydroData {
      *
      * @return the full linear restoring stiffness matrix for body b
      */
-    Eigen::MatrixXd GetLinMatrix(int b) const;
+    const Eigen::MatrixXd& GetLinMatrix(int b) const;
 
     /**
      * @brief Getter function for value in RIRF matrix.
@@ -149,7 +303,7 @@ class HydroData {
      *
      * @return cg vector from h5file
      */
-    Eigen::VectorXd GetCGVector(int b) const { return body_data_[b].cg; }
+    const Eigen::VectorXd& GetCGVector(int b) const { return body_data_[b].cg; }
 
     /**
      * @brief Get cb vector constant for a body.
@@ -158,7 +312,7 @@ class HydroData {
      *
      * @return cb vector from h5file
      */
-    Eigen::VectorXd GetCBVector(int b) const { return body_data_[b].cb; }
+    const Eigen::VectorXd& GetCBVector(int b) const { return body_data_[b].cb; }
 
     double GetExcitationIRFVal(int b, int dof, int s) const;  // TODO if this isn't used get rid of it
     Eigen::MatrixXd GetExcitationIRF(int b) const;            // TODO if this isn't used get rid of it
@@ -178,7 +332,14 @@ class HydroData {
      *
      * @return the Eigen::VectorXd of rirf_time_vector from h5 file
      */
-    Eigen::VectorXd GetRIRFTimeVector() const;
+    const Eigen::VectorXd& GetRIRFTimeVector() const;
+
+    /**
+     * @brief Get number of bodies in the data.
+     *
+     * @return number of bodies read from the h5 file
+     */
+    int GetNumBodies() const { return static_cast<int>(body_data_.size()); }
 
     /**
      * @brief Get water density rho.
@@ -196,6 +357,7 @@ class HydroData {
      * @return vector containing BodyInfo classes info for each body in system with hydro forces on it
      */
     std::vector<BodyInfo>& GetBodyInfos() { return body_data_; }
+    const std::vector<BodyInfo>& GetBodyInfos() const { return body_data_; }
 
     /**
      * @brief Get chunk of data corresponding to the SimulationParameters struct in this class.
@@ -205,6 +367,7 @@ class HydroData {
      * @return SimulationParameters info for the system
      */
     SimulationParameters& GetSimulationInfo() { return sim_data_; }
+    const SimulationParameters& GetSimulationInfo() const { return sim_data_; }
 
     /**
      * @brief Get chunk of data corresponding to the RegularWaveInfo struct in this class.
@@ -214,15 +377,116 @@ class HydroData {
      * @return vector containing RegularWaveInfo classes info for each body in system with hydro forces on it
      */
     std::vector<RegularWaveInfo>& GetRegularWaveInfos() { return reg_wave_data_; }
+    const std::vector<RegularWaveInfo>& GetRegularWaveInfos() const { return reg_wave_data_; }
 
     /**
      * @brief Get chunk of data corresponding to the IrregularWaveInfo struct in this class.
      *
-     * IrregularWaveInfo contains information for hydro forces from irregular waves.
+     * IrregularWaveInfo contains information for hydro forces from irregular waves. Modify the excitation IRFs with
+     * SetExcitationIRF().
      *
      * @return vector containing IrregularWaveInfo classes info for each body in system with hydro forces on it
      */
-    std::vector<IrregularWaveInfo>& GetIrregularWaveInfos() { return irreg_wave_data_; }
+    const std::vector<IrregularWaveInfo>& GetIrregularWaveInfos() const { return irreg_wave_data_; }
+
+    /**
+     * @brief Replaces the excitation IRF of a body and clears the GetResampledExcitationIRF() cache.
+     *
+     * Not thread safe with GetResampledExcitationIRF() calls on the same data.
+     *
+     * @param body body number, 0 indexed
+     * @param time time values of the IRF
+     * @param values IRF values, 6 x time.size()
+     *
+     * @exception std::runtime_error if the values do not have 6 rows and one column per time value
+     */
+    void SetExcitationIRF(int body, const Eigen::VectorXd& time, std::shared_ptr<const Eigen::MatrixXd> values);
+
+    /**
+     * @brief Resamples the excitation IRF of every body to time step dt ahead of the simulation.
+     *
+     * Fills the GetResampledExcitationIRF() cache, which a copy of the data (and the HydroDataCache) keeps, so
+     * IrregularWaves reuse the spline fit instead of redoing it for every run.
+     *
+     * @param dt time step to resample the excitation IRFs to, must be positive
+     */
+    void ResampleExcitationIRF(double dt);
+
+    /**
+     * @brief Gets the excitation IRF of a body resampled to time step dt, with its integration widths.
+     *
+     * Computed on the first call for each time step and cached with the data, so every IrregularWaves sharing this
+     * HydroData (e.g. the realizations of an ensemble) reuses the spline fit, and bodies sharing an identical IRF
+     * share the resampled one. Thread safe: the spline fit runs outside of the cache lock, concurrent calls for the
+     * same IRF and time step wait for the first one.
+     *
+     * @param body body number, 0 indexed
+     * @param dt time step to resample the excitation IRF to, must be positive
+     *
+     * @return resampled IRF, widths, weighted IRF and time values
+     */
+    std::shared_ptr<const ResampledExcitationIRF> GetResampledExcitationIRF(int body, double dt) const;
+
+    /**
+     * @brief Makes bodies share the storage of identical coefficients.
+     *
+     * Compares the linear restoring stiffness, the infinite frequency added mass, RIRF and frequency dependent
+     * radiation blocks and the excitation IRFs of all bodies, and replaces every block that matches an
+     * earlier one by a reference to it. Blocks a and b match if max|a - b| <= tolerance * max(max|a|, max|b|).
+     * H5FileInfo::ReadH5Data() already shares bit-identical blocks (tolerance 0), so this only needs to be called to
+     * share blocks that differ by round-off. Clears the GetResampledExcitationIRF() cache, so call it before
+     * ResampleExcitationIRF().
+     *
+     * @param tolerance relative tolerance for two blocks to be identical, 0 for bit-identical
+     *
+     * @return number of blocks that now reference an earlier identical block
+     */
+    int ShareIdenticalCoefficients(double tolerance = 0.0);
+};
+
+/**
+ * @brief Computes the trapezoidal integration width of each value of a sorted array.
+ *
+ * The width of a value is half the distance to each of its neighbours (the integration weights of the trapezoidal
+ * rule).
+ *
+ * @param values sorted values (e.g. IRF times or spectrum frequencies)
+ *
+ * @return width of each value
+ */
+Eigen::VectorXd GetTrapezoidalWidths(const Eigen::VectorXd& values);
+
+/**
+ * @brief Resamples an excitation IRF (6 rows, one column per time value) to a uniform time step.
+ *
+ * Values are interpolated with a cubic spline over the IRF time range.
+ *
+ * @param[in] time_old time values of the IRF
+ * @param[in] vals_old IRF values, 6 x time_old.size()
+ * @param[in] dt new time step
+ * @param[out] time_new resampled time values
+ * @param[out] vals_new resampled IRF values, 6 x time_new.size()
+ */
+void ResampleIRF(const Eigen::VectorXd& time_old,
+                 const Eigen::MatrixXd& vals_old,
+                 double dt,
+                 Eigen::VectorXd& time_new,
+                 Eigen::MatrixXd& vals_new);
+
+/**
+ * @brief Subset of the bodies and frequencies of an h5 file to load.
+ *
+ * Used to simulate a sub-array from a large farm BEM file: only the hyperslabs of the selected bodies (and
+ * frequencies) are read, and the coupling columns of the 6N column data (infinite frequency added mass, RIRF) are
+ * re-indexed to the selected bodies, in the order of body_indices.
+ */
+struct HydroDataSelection {
+    /// @brief 0 indexed h5 body numbers to load (body1 is 0), in the order the bodies are added to the system
+    std::vector<int> body_indices;
+    /// @brief smallest frequency (rad/s) to load frequency dependent data for
+    double omega_min = 0.0;
+    /// @brief largest frequency (rad/s) to load frequency dependent data for
+    double omega_max = std::numeric_limits<double>::infinity();
 };
 
 // TODO change name to LoadH5File or ReadH5File or H5Init or something similar to give better description of
@@ -239,6 +503,14 @@ class H5FileInfo {
      * note, hydrobodies should be added to system before any non hydrobodies
      */
     H5FileInfo(std::string file, int num_bod = 1);
+
+    /**
+     * @brief prepares for reading a subset of the bodies and frequencies of an h5 file, checks file exists.
+     *
+     * @param file string containing file name for h5 hydro data file
+     * @param selection bodies (in system order) and frequency range to read from the h5 file
+     */
+    H5FileInfo(std::string file, HydroDataSelection selection);
     H5FileInfo() = delete;
 
     H5FileInfo(const H5FileInfo& old) = default;
@@ -262,6 +534,7 @@ class H5FileInfo {
   private:
     std::string h5_file_name_;
     int num_bodies_;
+    HydroDataSelection selection_;
 
     /**
      * @brief helper function for readH5Data() to initialize any scalars.
@@ -312,6 +585,63 @@ class H5FileInfo {
      * @return 2D matrix representing same data as to_be_squeezed, but in Eigen::Matrix, it is much easier to handle
      */
     Eigen::MatrixXd SqueezeMid(Eigen::Tensor<double, 3>& to_be_squeezed);
+
+    /**
+     * @brief helper function for readH5Data() to read a block of a dataset (HDF5 hyperslab).
+     *
+     * @param[in] file open h5 file reference to read data from
+     * @param[in] data_name data name within file to extract values from
+     * @param[in] start first index of the block in each dimension
+     * @param[in] count size of the block in each dimension
+     * @param[out] var values of the block, in row major (h5) order
+     */
+    void ReadHyperslab(H5::H5File& file,
+                       const std::string& data_name,
+                       const std::vector<size_t>& start,
+                       const std::vector<size_t>& count,
+                       std::vector<double>& var);
+
+    /**
+     * @brief helper function for readH5Data() to get the dimensions of a dataset.
+     *
+     * @param[in] file open h5 file reference to read data from
+     * @param[in] data_name data name within file
+     *
+     * @return size of each dimension of the dataset
+     */
+    std::vector<size_t> GetDims(H5::H5File& file, const std::string& data_name);
+
+    /**
+     * @brief helper function for readH5Data() to read the selected bodies' coupling columns of 6 x 6N (x M) data.
+     *
+     * Block c of blocks holds the columns 6 * body_indices[c], ..., 6 * body_indices[c] + 5 of the dataset.
+     *
+     * @param[in] file open h5 file reference to read data from
+     * @param[in] data_name data name within file to extract values from, 2D (6 x 6N) or 3D (6 x 6N x M)
+     * @param[out] blocks one 6 x 6 x M tensor per selected body (M is 1 for 2D data)
+     * @param[in] depth_start first index of the third dimension to read (3D data only)
+     * @param[in] depth_count number of indices of the third dimension to read, -1 for all (3D data only)
+     */
+    void InitCoupled(H5::H5File& file,
+                     const std::string& data_name,
+                     std::vector<Eigen::Tensor<double, 3>>& blocks,
+                     int depth_start = 0,
+                     int depth_count = -1);
+
+    /**
+     * @brief helper function for readH5Data() to read the selected frequencies of rows x cols x F data.
+     *
+     * @param[in] file open h5 file reference to read data from
+     * @param[in] data_name data name within file to extract values from
+     * @param[in] freq_start index of the first selected frequency
+     * @param[in] freq_count number of selected frequencies
+     * @param[out] var rows x cols x freq_count tensor
+     */
+    void InitFrequencySlice(H5::H5File& file,
+                            const std::string& data_name,
+                            int freq_start,
+                            int freq_count,
+                            Eigen::Tensor<double, 3>& var);
 };
 
 #endif
\ No newline at end of file
@@ -4,7 +4,9 @@
 #pragma once
 
 #include <Eigen/Dense>  // Need for the container function
+#include <cstddef>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <string>
 
@@ -43,6 +45,67 @@ int SetInitialEnvironment(int argc, char* argv[]) noexcept;
  * @return the string containing the path in standard format
  */
 std::string getDataDir() noexcept;
+
+/**@brief Read-only memory mapping of a whole file.
+ *
+ * The file is mapped shared and read-only, so processes mapping the same file share its pages in the OS page
+ * cache. The mapping lives as long as the object.
+ */
+class MappedFile {
+  public:
+    /**@brief Maps the given file.
+     *
+     * @param file_name path of the file to map
+     * @exception std::runtime_error if the file cannot be opened or mapped
+     */
+    explicit MappedFile(const std::string& file_name);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**@brief Pointer to the first byte of the mapped file (nullptr for an empty file).
+     */
+    const char* GetData() const { return data_; }
+
+    /**@brief Size of the mapped file in bytes.
+     */
+    size_t GetSize() const { return size_; }
+
+  private:
+    const char* data_ = nullptr;
+    size_t size_      = 0;
+#ifdef _WIN32
+    void* file_handle_    = nullptr;
+    void* mapping_handle_ = nullptr;
+#else
+    int file_descriptor_ = -1;
+#endif
+};
+
+/**@brief Runs a loop over [0, count) on several threads.
+ *
+ * The range is split into one contiguous chunk per thread and body(begin, end) is called once per chunk. Results are
+ * deterministic (independent of the number of threads) as long as body only writes to the indices of its chunk.
+ *
+ * @param count number of loop iterations
+ * @param num_threads number of threads, 0 (or negative) for the number of hardware threads
+ * @param body function called with the [begin, end) index range of each chunk
+ */
+void ParallelFor(size_t count, int num_threads, const std::function<void(size_t, size_t)>& body);
+
+/**@brief Computes the sine and cosine of every element of an array in one pass.
+ *
+ * Range reduction to [-pi/4, pi/4] and polynomial evaluation are written as Eigen array expressions, so they are
+ * vectorized (std::sin/std::cos are not for double). Accurate to a few ulp for |x| < 1e6, larger arguments fall back
+ * to std::sin/std::cos.
+ *
+ * @param[in] x angles (rad)
+ * @param[out] sin_x sine of x, resized to the size of x
+ * @param[out] cos_x cosine of x, resized to the size of x
+ */
+void SinCos(const Eigen::ArrayXd& x, Eigen::ArrayXd& sin_x, Eigen::ArrayXd& cos_x);
+
 template <typename T>
 void WriteDataToFile(const std::vector<T>& data, const std::string& filename) {
     std::ofstream outFile(filename);
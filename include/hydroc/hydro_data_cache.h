@@ -0,0 +1,120 @@
+#ifndef HYDRO_DATA_CACHE_H
+#define HYDRO_DATA_CACHE_H
+/*********************************************************************
+ * @file  hydro_data_cache.h
+ *
+ * @brief header file of HydroDataCache, an on-disk binary cache of \
+ * preprocessed HydroData.
+ *********************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <hydroc/h5fileinfo.h>
+
+/**
+ * @brief Preprocessing applied to HydroData before it is cached. Every option is part of the cache key.
+ */
+struct HydroDataPreprocessOptions {
+    /// @brief Bodies and frequencies to load (see H5FileInfo), no body indices for the first num_bodies bodies
+    HydroDataSelection selection;
+    /// @brief Relative tolerance of HydroData::ShareIdenticalCoefficients() when positive, 0 to only share
+    /// bit-identical blocks as ReadH5Data() does
+    double share_tolerance = 0.0;
+    /// @brief Time step the excitation IRFs are resampled to (usually the simulation time step), 0 to skip
+    double excitation_irf_dt = 0.0;
+};
+
+/**
+ * @brief On-disk cache of preprocessed HydroData.
+ *
+ * The cache saves the parsing and preprocessing time of every run, not memory: each process owns a copy of the data.
+ * The first Load() for a given h5 file, number of bodies and set of preprocessing options reads the h5 file with
+ * H5FileInfo, applies the preprocessing and writes the result to a binary cache file. Later loads (from this or any
+ * other process) memory map the cache file read-only and copy the arrays out of it, skipping the HDF5 parsing,
+ * rescaling and IRF spline fits. HydroData owns its coefficient matrices, so processes loading the same cache file
+ * do not share its pages. Coefficient blocks shared between bodies (see HydroData::ShareIdenticalCoefficients()) are
+ * stored once and stay shared after loading.
+ *
+ * Cache files are keyed by the h5 file path, size and modification time plus the preprocessing options, so looking
+ * up the cache does not read the h5 file and a rewritten h5 file or a different time step never reuses stale data.
+ * With hash_content, the key also includes a hash of the h5 file content (reads the whole h5 file on every Load(),
+ * for h5 files modified without changing their size and modification time). Cache files are written to a temporary
+ * file and renamed, so concurrent processes never see a partially written cache.
+ */
+class HydroDataCache {
+  public:
+    /**
+     * @brief Sets the directory the cache files are stored in, created if it does not exist yet.
+     *
+     * @param cache_dir directory to store cache files in
+     * @param hash_content also key the cache files on a hash of the h5 file content
+     */
+    explicit HydroDataCache(std::string cache_dir, bool hash_content = false);
+
+    /**
+     * @brief Returns the preprocessed HydroData for the h5 file, from the cache if possible.
+     *
+     * @param h5_file_name h5 hydro data file
+     * @param num_bodies number of hydro bodies to read from the h5 file
+     * @param options preprocessing to apply before the data is cached
+     *
+     * @return HydroData, identical to H5FileInfo(h5_file_name, num_bodies).ReadH5Data() (or the selection of
+     * options) plus preprocessing
+     *
+     * @exception std::runtime_error if the selection of options does not have num_bodies body indices
+     */
+    HydroData Load(const std::string& h5_file_name, int num_bodies, const HydroDataPreprocessOptions& options = {});
+
+    /**
+     * @brief Gets the path of the cache file that Load() uses for these arguments.
+     *
+     * Uses the size and modification time of the h5 file, so the h5 file needs to exist.
+     *
+     * @param h5_file_name h5 hydro data file
+     * @param num_bodies number of hydro bodies to read from the h5 file
+     * @param options preprocessing to apply before the data is cached
+     *
+     * @return path of the cache file (it may not exist yet)
+     */
+    std::string GetCacheFilePath(const std::string& h5_file_name,
+                                 int num_bodies,
+                                 const HydroDataPreprocessOptions& options = {}) const;
+
+  private:
+    std::string cache_dir_;
+    bool hash_content_;
+
+    /**
+     * @brief Computes the cache key from the h5 file path, size, modification time (and content with hash_content_),
+     * number of bodies and preprocessing options.
+     */
+    uint64_t ComputeKey(const std::string& h5_file_name,
+                        int num_bodies,
+                        const HydroDataPreprocessOptions& options) const;
+
+    /**
+     * @brief Builds the cache file path from the h5 file name and cache key.
+     */
+    std::string GetCacheFilePath(const std::string& h5_file_name, uint64_t key) const;
+
+    /**
+     * @brief Memory maps a cache file and copies its content into a new HydroData object, with the resampled
+     * excitation IRFs in its HydroData::GetResampledExcitationIRF() cache.
+     *
+     * @exception std::runtime_error if the file is truncated or its header does not match the key
+     */
+    HydroData ReadCacheFile(const std::string& cache_file, uint64_t key) const;
+
+    /**
+     * @brief Writes data, with its excitation IRFs resampled as set in options, to the cache file (through a
+     * temporary file renamed in place).
+     */
+    void WriteCacheFile(const HydroData& data,
+                        const HydroDataPreprocessOptions& options,
+                        const std::string& cache_file,
+                        uint64_t key) const;
+};
+
+#endif
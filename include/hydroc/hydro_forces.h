@@ -169,6 +169,30 @@ class TestHydro {
               std::string h5_file_name,
               std::shared_ptr<WaveBase> waves = std::make_shared<NoWave>());
 
+    /**
+     * @brief Constructor for already loaded hydro data (e.g. from HydroDataCache).
+     *
+     * @param user_bodies List of pointers to bodies for the hydro forces.
+     * @param hydro_data Hydro data for the bodies, in the same order as user_bodies.
+     * @param waves WaveBase object. Defaults to NoWave if not provided.
+     */
+    TestHydro(std::vector<std::shared_ptr<ChBody>> user_bodies,
+              HydroData hydro_data,
+              std::shared_ptr<WaveBase> waves = std::make_shared<NoWave>());
+
+    /**
+     * @brief Constructor for hydro data shared with other TestHydro objects.
+     *
+     * The data is referenced, not copied, so many simulations in one process can use the same loaded h5 file.
+     *
+     * @param user_bodies List of pointers to bodies for the hydro forces.
+     * @param hydro_data Shared hydro data for the bodies, in the same order as user_bodies.
+     * @param waves WaveBase object. Defaults to NoWave if not provided.
+     */
+    TestHydro(std::vector<std::shared_ptr<ChBody>> user_bodies,
+              std::shared_ptr<const HydroData> hydro_data,
+              std::shared_ptr<WaveBase> waves = std::make_shared<NoWave>());
+
     // Deleted copy constructor and assignment operator for safety.
     TestHydro(const TestHydro& old) = delete;
     TestHydro& operator=(const TestHydro& rhs) = delete;
@@ -237,7 +261,7 @@ class TestHydro {
     // Class properties related to the body and hydrodynamics
     std::vector<std::shared_ptr<ChBody>> bodies_;
     int num_bodies_;
-    HydroData file_info_;
+    std::shared_ptr<const HydroData> file_info_;
     std::vector<ForceFunc6d> force_per_body_;
     std::shared_ptr<WaveBase> user_waves_;
 
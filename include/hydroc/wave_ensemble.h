@@ -0,0 +1,82 @@
+#ifndef WAVE_ENSEMBLE_H
+#define WAVE_ENSEMBLE_H
+/*********************************************************************
+ * @file  wave_ensemble.h
+ *
+ * @brief header file of IrregularWaveEnsemble, many random phase \
+ * realizations of one irregular sea state.
+ *********************************************************************/
+#pragma once
+
+#include <hydroc/h5fileinfo.h>
+#include <hydroc/wave_types.h>
+
+#include <memory>
+#include <vector>
+
+#include <Eigen/Dense>
+
+/**
+ * @brief One realization of an IrregularWaveEnsemble.
+ */
+struct IrregularWaveRealization {
+    int seed = 0;
+    // waves of the realization: free surface elevation (GetFreeSurfaceElevation() on GetFreeSurfaceTime()),
+    // kinematics, or the waves of a simulation
+    std::shared_ptr<IrregularWaves> waves;
+    // excitation force of all bodies (row 6 b + dof for body b) at IrregularWaveEnsemble::GetExcitationTimes(), one
+    // column per time; empty if not computed
+    Eigen::MatrixXd excitation_force;
+};
+
+/**
+ * @brief Generates many realizations (random phase seeds) of one irregular sea state, e.g. for Monte Carlo studies.
+ *
+ * The seed independent setup (spectrum, wave numbers, directions, resampled excitation IRFs) is done once in the
+ * constructor. Generate() only draws the phases of each seed and computes what depends on them, for several seeds in
+ * parallel. Each seed has its own random stream: the realization of a seed is the same as an IrregularWaves with
+ * IrregularWaveParams::seed_ = seed, whatever the other seeds and the number of threads.
+ *
+ * Realizations do not write the diagnostics series (the "spectral_densities" series is written once by the
+ * constructor).
+ */
+class IrregularWaveEnsemble {
+  public:
+    /**
+     * @brief Sets up the sea state shared by the realizations.
+     *
+     * @param params parameters of the sea state (seed_ is not used), num_threads_ is the number of realizations
+     * generated at the same time
+     * @param hydro_data shared h5 data
+     *
+     * @exception std::runtime_error if the parameters do not describe a wave spectrum (wave height and period, no eta
+     * file) or simulation_dt_ is not positive
+     */
+    IrregularWaveEnsemble(const IrregularWaveParams& params, std::shared_ptr<const HydroData> hydro_data);
+
+    /**
+     * @brief Generates the realizations of several seeds in parallel.
+     *
+     * @param seeds seeds of the random phases, one realization per seed
+     * @param compute_excitation also compute IrregularWaveRealization::excitation_force, from the excitation force
+     * precomputed by FFT convolution (as with IrregularWaveParams::precompute_excitation_force_, the parameters of
+     * the realizations are unchanged) or synthesized in the frequency domain
+     *
+     * @return realization of each seed, in the order of the seeds
+     *
+     * @exception std::runtime_error if compute_excitation is set with IrregularWaveParams::streaming_free_surface_
+     */
+    std::vector<IrregularWaveRealization> Generate(const std::vector<int>& seeds, bool compute_excitation = true) const;
+
+    /**
+     * @brief Gets the times of the excitation force series, every simulation_dt_ from 0 to simulation_duration_.
+     */
+    Eigen::VectorXd GetExcitationTimes() const;
+
+  private:
+    IrregularWaveParams params_;
+    // seed independent setup, copied by each realization
+    std::shared_ptr<IrregularWaves> sea_state_;
+};
+
+#endif
@@ -7,8 +7,12 @@
  * @brief header file for Wavebase and classes inheriting from WaveBase.
  *********************************************************************/
 #pragma once
+#include <hydroc/diagnostics.h>
 #include <hydroc/h5fileinfo.h>
 #include <Eigen/Dense>
+#include <complex>
+#include <limits>
+#include <memory>
 
 // todo move this helper function somewhere else?
 Eigen::VectorXd PiersonMoskowitzSpectrumHz(Eigen::VectorXd& f, double Hs, double Tp);
@@ -37,13 +41,133 @@ std::vector<double> GetFreeSurfaceElevationTimeSeries(const Eigen::VectorXd& fre
                                                       const Eigen::VectorXd& time_array,
                                                       double water_depth);
 
+/**
+ * @brief h5 wave headings around a heading, see GetHeadingInterp().
+ */
+struct HeadingInterp {
+    int index;        // lower h5 heading
+    int upper_index;  // upper h5 heading, index + 1, or 0 across the seam of headings around the whole circle
+    double weight;    // weight of the upper h5 heading, 0 if it is not used
+};
+
+/**
+ * @brief Finds the h5 wave headings around a heading for linear interpolation of the excitation coefficients.
+ *
+ * The heading is wrapped by multiples of 360 degrees into the range of the h5 headings. When the h5 headings go
+ * around the whole circle (the gap from the last heading to the first heading + 360 is not larger than the steps
+ * between headings, e.g. 0 to 350 by 10), headings after the last one are interpolated between the last and the first
+ * heading.
+ *
+ * @param headings wave headings of the h5 file (degrees, increasing), see HydroData::SimulationParameters
+ * @param heading wave heading (degrees)
+ *
+ * @return indices and weight of the h5 headings
+ *
+ * @exception std::runtime_error if the heading is outside of the h5 headings
+ */
+HeadingInterp GetHeadingInterp(const Eigen::VectorXd& headings, double heading);
+
+/**
+ * @brief Interpolates the excitation magnitude and phase of one dof linearly in heading and frequency.
+ *
+ * Phases are interpolated along the shortest arc between the h5 values, so phases on both sides of +/- pi are not
+ * averaged through 0.
+ *
+ * @param[in] reg excitation coefficients of a body
+ * @param[in] dof dof of the coefficients
+ * @param[in] heading h5 headings around the wave heading (see GetHeadingInterp())
+ * @param[in] freq frequency interpolation (see FrequencyTable::Lookup())
+ * @param[out] magnitude interpolated excitation magnitude
+ * @param[out] phase interpolated excitation phase (rad)
+ */
+void InterpolateExcitation(const HydroData::RegularWaveInfo& reg,
+                           int dof,
+                           const HeadingInterp& heading,
+                           const FrequencyTable::Interp& freq,
+                           double& magnitude,
+                           double& phase);
+
+/**
+ * @brief Computes the free surface elevation of an irregular wave on a uniform time grid with FFTs.
+ *
+ * Same realization as evaluating sum_i a_i cos(k_i x - omega_i t + phi_i) at every time (a_i = sqrt(2 S_i w_i)),
+ * for components on a uniform frequency grid. The sum over components at all times is a chirp-z transform, computed
+ * with Bluestein's algorithm (FFT based convolution), so the cost is O((M + N) log(M + N)) instead of O(M N) cos
+ * evaluations for M components and N times.
+ *
+ * @param position position of the elevation, the wave travels along the global X axis
+ * @param t0 first time
+ * @param dt time step
+ * @param num_times number of times
+ * @param freqs_hz component frequencies (Hz), uniformly spaced
+ * @param spectral_densities spectral density of each component
+ * @param spectral_widths frequency width of each component
+ * @param wave_phases phase of each component
+ * @param wavenumbers wave number of each component
+ *
+ * @return free surface elevation at t0 + n dt, n = 0,...,num_times-1
+ *
+ * @exception std::runtime_error if the frequencies are not uniformly spaced
+ */
+std::vector<double> GetEtaIrregularTimeSeriesFFT(const Eigen::Vector3d& position,
+                                                 double t0,
+                                                 double dt,
+                                                 int num_times,
+                                                 const Eigen::VectorXd& freqs_hz,
+                                                 const Eigen::VectorXd& spectral_densities,
+                                                 const Eigen::VectorXd& spectral_widths,
+                                                 const Eigen::VectorXd& wave_phases,
+                                                 const Eigen::VectorXd& wavenumbers);
+
+/**
+ * @brief Reads a free surface elevation series (IrregularWaveParams::eta_file_path_).
+ *
+ * The format follows the file extension:
+ * - ".bin": binary file written by WriteEtaFile(), a header followed by the times and the elevations as native
+ *   doubles, copied from the memory mapped file without parsing
+ * - ".h5" or ".hdf5": HDF5 file with the 1D datasets "time" and "eta"
+ * - anything else: text file with one "time : eta" line per sample
+ *
+ * @param[in] file_name path of the file
+ * @param[out] times sample times
+ * @param[out] eta free surface elevation at the times
+ *
+ * @exception std::runtime_error if the file cannot be read or parsed
+ */
+void ReadEtaFile(const std::string& file_name, std::vector<double>& times, std::vector<double>& eta);
+
+/**
+ * @brief Writes a free surface elevation series in the format read by ReadEtaFile(), chosen by the file extension.
+ *
+ * @param file_name path of the file
+ * @param times sample times
+ * @param eta free surface elevation at the times
+ *
+ * @exception std::runtime_error if the sizes differ or the file cannot be written
+ */
+void WriteEtaFile(const std::string& file_name, const std::vector<double>& times, const std::vector<double>& eta);
+
 enum class WaveMode {
     /// @brief No waves
     noWaveCIC = 0,
     /// @brief Regular waves
     regular = 1,
     /// @brief Irregular waves
-    irregular = 2
+    irregular = 2,
+    /// @brief Sum of a few regular wave components
+    polychromatic = 3
+};
+
+/**
+ * @brief Free surface elevation and water kinematics at a point, see WaveBase::GetKinematics().
+ */
+struct WaveKinematics {
+    /// @brief free surface elevation at the horizontal position of the point
+    double elevation = 0.0;
+    /// @brief water velocity
+    Eigen::Vector3d velocity = Eigen::Vector3d::Zero();
+    /// @brief water acceleration
+    Eigen::Vector3d acceleration = Eigen::Vector3d::Zero();
 };
 
 /**
@@ -72,6 +196,48 @@ class WaveBase {
 
     virtual Eigen::Vector3d GetAcceleration(const Eigen::Vector3d& position, double time) = 0;
 
+    /**
+     * @brief Computes the free surface elevation at several points at one time.
+     *
+     * The default calls GetElevation() for each point, wave types override it to share the work across points.
+     *
+     * @param[in] positions N x 3 positions, one point per row (x, y and z are each contiguous)
+     * @param[in] time time of the evaluation
+     * @param[out] elevations N elevations, resized only if its size differs
+     */
+    virtual void GetElevations(const Eigen::MatrixX3d& positions, double time, Eigen::VectorXd& elevations);
+
+    /**
+     * @brief Computes the water velocity at several points at one time.
+     *
+     * @param[in] positions N x 3 positions, one point per row
+     * @param[in] time time of the evaluation
+     * @param[out] velocities N x 3 velocities, resized only if its size differs
+     */
+    virtual void GetVelocities(const Eigen::MatrixX3d& positions, double time, Eigen::MatrixX3d& velocities);
+
+    /**
+     * @brief Computes the water acceleration at several points at one time.
+     *
+     * @param[in] positions N x 3 positions, one point per row
+     * @param[in] time time of the evaluation
+     * @param[out] accelerations N x 3 accelerations, resized only if its size differs
+     */
+    virtual void GetAccelerations(const Eigen::MatrixX3d& positions, double time, Eigen::MatrixX3d& accelerations);
+
+    /**
+     * @brief Computes the free surface elevation, water velocity and water acceleration at a point in one call.
+     *
+     * The default calls GetElevation(), GetVelocity() and GetAcceleration(), wave types override it to share the
+     * component phases and depth factors between the three.
+     *
+     * @param position position of the point
+     * @param time time of the evaluation
+     *
+     * @return elevation, velocity and acceleration
+     */
+    virtual WaveKinematics GetKinematics(const Eigen::Vector3d& position, double time);
+
     /// @brief Mean water level
     double mwl_ = 0.0;
     /// @brief Gravitational acceleration
@@ -144,6 +310,11 @@ class RegularWave : public WaveBase {
     /**
      * @brief calculates the force from the regular wave at time t.
      *
+     * The force of each dof is Re(c * A * exp(i omega t)) with the complex excitation coefficient c computed in
+     * Initialize(). When t advances by the same step as the previous call, exp(i omega t) is advanced by one complex
+     * rotation instead of evaluating cos for every dof, and recomputed exactly every excitation_reanchor_steps_ steps
+     * to bound the round-off drift. Repeated calls at the same time return the same force.
+     *
      * Note if AdddH5Data and Initialize have not been called first, there will be issues.
      * TODO: add checks that these functions have been called in correct order.
      *
@@ -165,16 +336,23 @@ class RegularWave : public WaveBase {
     double regular_wave_amplitude_;
     double regular_wave_omega_;
     double regular_wave_phase_ = 0.0;
+    /// @brief wave heading (degrees, 0 along +x, 90 along +y): the kinematics travel along it and the excitation is
+    /// interpolated between the headings of the h5 file
+    double regular_wave_heading_ = 0.0;
+    /// @brief constant time steps between exact evaluations of the excitation phase, 0 evaluates it exactly every call
+    int excitation_reanchor_steps_ = 1000;
 
     /**
      * @brief Initializes other member variables for timestep calculations later.
      *
-     * Links the HydroData::RegularWaveInfo chunk to RegularWave for use in calculations.
+     * Links the shared HydroData to RegularWave for use in calculations (the data is not copied).
      * Should be called before Initialize().
      *
-     * @param reg_h5_data reference to chunk of h5 data needed for RegularWave calculations
+     * @param hydro_data shared h5 data, the HydroData::RegularWaveInfo chunk is used for RegularWave calculations
+     *
+     * @exception std::runtime_error if regular_wave_heading_ is outside of the headings of the h5 file
      */
-    void AddH5Data(std::vector<HydroData::RegularWaveInfo>& reg_h5_data, HydroData::SimulationParameters& sim_data);
+    void AddH5Data(std::shared_ptr<const HydroData> hydro_data);
 
     double GetElevation(const Eigen::Vector3d& position, double time) override;
 
@@ -182,51 +360,132 @@ class RegularWave : public WaveBase {
 
     Eigen::Vector3d GetAcceleration(const Eigen::Vector3d& position, double time) override;
 
+    void GetElevations(const Eigen::MatrixX3d& positions, double time, Eigen::VectorXd& elevations) override;
+
+    void GetVelocities(const Eigen::MatrixX3d& positions, double time, Eigen::MatrixX3d& velocities) override;
+
+    void GetAccelerations(const Eigen::MatrixX3d& positions, double time, Eigen::MatrixX3d& accelerations) override;
+
   private:
     unsigned int num_bodies_;
     const WaveMode mode_ = WaveMode::regular;
-    std::vector<HydroData::RegularWaveInfo> wave_info_;
+    std::shared_ptr<const HydroData> hydro_data_;
     Eigen::VectorXd excitation_force_mag_;
     Eigen::VectorXd excitation_force_phase_;
     Eigen::VectorXd force_;
     double wavenumber_;
+    // direction of the heading, the kinematics travel along it
+    double heading_cos_ = 1.0;
+    double heading_sin_ = 0.0;
+
+    // complex excitation coefficients mag * exp(i phase), real and imaginary parts per dof
+    Eigen::VectorXd excitation_coef_re_;
+    Eigen::VectorXd excitation_coef_im_;
+    // exp(i omega t) at the time of the last force evaluation, rotated by exp(i omega dt) for constant time steps
+    std::complex<double> time_phasor_;
+    std::complex<double> step_rotation_;
+    double phasor_time_     = std::numeric_limits<double>::quiet_NaN();
+    double phasor_dt_       = std::numeric_limits<double>::quiet_NaN();
+    int steps_since_anchor_ = 0;
+};
+
+/**
+ * @brief class to instantiate WaveBase for a wave made of a few discrete regular components (bichromatic,
+ * polychromatic), e.g. to reproduce tank tests.
+ *
+ * Each component c has its own frequency, amplitude and phase, with the free surface elevation
+ * sum_c A_c cos(k_c (x cos(theta) + y sin(theta)) - omega_c t + phi_c) for the wave heading theta, as
+ * RegularWave. The excitation coefficients of every component are interpolated from the h5 data once in
+ * Initialize(), so the force, elevation and kinematics are sums over the components evaluated with one batch of
+ * cos/sin per call.
+ */
+class PolychromaticWave : public WaveBase {
+  public:
+    /**
+     * @brief default constructor for PolychromaticWave, for 1 body.
+     */
+    PolychromaticWave();
 
     /**
-     * @brief Finds omega_max and number of frequencies, then gets omega_max / num_freqs.
+     * @brief constructor for PolychromaticWave in multibody cases.
      *
-     * Helper function for RegularWave calculations.
-     *
-     * @return omega step size
+     * @param num_b number of bodies to apply hydro forces to (usually number of bodies in system)
      */
-    double GetOmegaDelta() const;
+    PolychromaticWave(unsigned int num_b);
 
     /**
-     * @brief gets interpolated excitation magnitude value.
+     * @brief Computes the excitation coefficients and wave numbers of the components.
      *
-     * Helper function for RegWave calculations.
+     * Assumes AddH5Data() has been called and the components are set.
      *
-     * @param b body to get matrix from
-     * @param i row of matrix to look at
-     * @param j column of matrix
-     * @param freq_index_des TODO: what to call this
+     * @exception std::runtime_error if the component vectors have different sizes, or a component frequency or
+     * wave_heading_ is outside of the h5 data
+     */
+    void Initialize() override;
+
+    /**
+     * @brief calculates the force from all wave components at time t.
+     *
+     * @param t time to calculate force at
      *
-     * @return excitation magnitudes for body b, row i, column j, frequency ix k
+     * @return 6N dimensional force vector, where N is number of bodies with hydroforces
      */
-    double GetExcitationMagInterp(int b, int i, int j, double freq_index_des) const;
+    Eigen::VectorXd GetForceAtTime(double t) override;
 
     /**
-     * @brief gets interpolated excitation phase value.
+     * @brief gets wave mode.
      *
-     * Helper function for RegWave calculations.
+     * @return WaveMode enum for PolychromaticWave is polychromatic
+     */
+    WaveMode GetWaveMode() override { return mode_; }
+
+    /**
+     * @brief Links the shared HydroData to PolychromaticWave for use in calculations (the data is not copied).
      *
-     * @param b body to get matrix from
-     * @param i row of matrix to look at
-     * @param j column of matrix
-     * @param freq_index_des TODO: what to call this
+     * Should be called before Initialize().
      *
-     * @return excitation phases for body b, row i, column j, frequency ix k
+     * @param hydro_data shared h5 data, the HydroData::RegularWaveInfo chunk is used for the excitation
      */
-    double GetExcitationPhaseInterp(int b, int i, int j, double freq_index_des) const;
+    void AddH5Data(std::shared_ptr<const HydroData> hydro_data);
+
+    double GetElevation(const Eigen::Vector3d& position, double time) override;
+
+    Eigen::Vector3d GetVelocity(const Eigen::Vector3d& position, double time) override;
+
+    Eigen::Vector3d GetAcceleration(const Eigen::Vector3d& position, double time) override;
+
+    void GetElevations(const Eigen::MatrixX3d& positions, double time, Eigen::VectorXd& elevations) override;
+
+    void GetVelocities(const Eigen::MatrixX3d& positions, double time, Eigen::MatrixX3d& velocities) override;
+
+    void GetAccelerations(const Eigen::MatrixX3d& positions, double time, Eigen::MatrixX3d& accelerations) override;
+
+    // user input variables, one entry per component
+    /// @brief component frequencies (rad/s)
+    Eigen::VectorXd component_omegas_;
+    /// @brief component amplitudes (m)
+    Eigen::VectorXd component_amplitudes_;
+    /// @brief component phases (rad), all 0 if left empty
+    Eigen::VectorXd component_phases_;
+    /// @brief wave heading (degrees, 0 along +x, 90 along +y) of all components: the kinematics travel along it and
+    /// the excitation is interpolated between the h5 headings
+    double wave_heading_ = 0.0;
+
+  private:
+    unsigned int num_bodies_;
+    const WaveMode mode_ = WaveMode::polychromatic;
+    std::shared_ptr<const HydroData> hydro_data_;
+    Eigen::VectorXd wavenumbers_;
+    Eigen::VectorXd phases_;
+    // direction of the heading, the kinematics travel along it
+    double heading_cos_ = 1.0;
+    double heading_sin_ = 0.0;
+    // complex excitation A_c * mag * exp(i (phase - phi_c)) of each dof (rows) and component (columns)
+    Eigen::MatrixXd excitation_coef_re_;
+    Eigen::MatrixXd excitation_coef_im_;
+    Eigen::VectorXd force_;
+    Eigen::ArrayXd cos_buffer_;
+    Eigen::ArrayXd sin_buffer_;
 };
 
 //// class to instantiate WaveBase for irregular waves
@@ -279,6 +538,7 @@ struct IrregularWaveParams {
     double simulation_dt_;
     double simulation_duration_;
     double ramp_duration_ = 0.0;
+    // free surface elevation series to use instead of a spectrum, text, binary or HDF5 (see ReadEtaFile())
     std::string eta_file_path_;
     double wave_height_             = 0.0;
     double wave_period_             = 0.0;
@@ -289,6 +549,54 @@ struct IrregularWaveParams {
     bool is_normalized_             = false;
     int seed_                       = 1;
     bool wave_stretching_           = true;
+    // compute the precomputed free surface elevation with FFTs (same realization as the direct sum of cosines)
+    bool fft_free_surface_ = true;
+    // threads for the wave precomputations (direct free surface sums), 0 for all hardware threads;
+    // results do not depend on the number of threads
+    int num_threads_ = 0;
+    // generate the free surface elevation in blocks ahead of the simulation time, keeping only a sliding window that
+    // covers the excitation IRF, instead of precomputing it for the whole simulation (memory bounded for any
+    // simulation duration, the "eta" diagnostics series is not written). Only for waves from a spectrum, with an
+    // explicit nfrequencies_ (the automatic number of frequencies grows with simulation_duration_)
+    bool streaming_free_surface_ = false;
+    // duration of the blocks generated when streaming
+    double streaming_block_duration_ = 600.0;
+    // compute the excitation force of each body over the whole free surface elevation (from the spectrum or the eta
+    // file) at setup, with an FFT convolution of the elevation with the excitation IRF; GetForceAtTime then
+    // interpolates the precomputed force instead of convolving at every step. Needs a uniformly sampled IRF
+    // (simulation_dt_ > 0), not with streaming_free_surface_
+    bool precompute_excitation_force_ = false;
+    // synthesize the excitation force of waves from a spectrum as the sum of |X(omega)| A cos(omega t + phi +
+    // arg(X(omega))) over the components, with the h5 excitation coefficients X, instead of the excitation IRF
+    // convolution. Components outside of the h5 frequencies have no excitation (with a warning above 0.1% of the wave
+    // energy). The IRF is not resampled and the free surface elevation is not precomputed. Always used by
+    // directional seas. With a ramp the force itself is ramped linearly from 0 at t = 0, whereas the convolution ramps
+    // the elevation from the start of its series (irf_time_max before t = 0) and then convolves it, so its force does
+    // not start from 0. Both reach the unramped force at t = ramp_duration_ and only differ before
+    bool frequency_domain_excitation_ = false;
+    // reference position of each body for the excitation (e.g. its center of gravity at rest), the free surface
+    // elevation series convolved with the excitation IRF of body b is computed at eta_reference_positions_[b];
+    // empty for one series at the origin shared by all bodies
+    std::vector<Eigen::Vector3d> eta_reference_positions_;
+    // directional spreading (short-crested seas), directions in degrees as the h5 wave headings (0 along +x, 90
+    // along +y). Any of num_directions_ > 1, a spreading table or mean_direction_ != 0 makes the sea directional:
+    // its excitation is then synthesized from the h5 excitation coefficients interpolated in heading, instead of the
+    // excitation IRF convolution (which only exists for the first h5 heading)
+    double mean_direction_ = 0.0;
+    // number of directions of the cos-2s spreading D(theta) ~ cos^(2s)((theta - mean_direction_) / 2), 1 for
+    // long-crested waves along mean_direction_
+    int num_directions_ = 1;
+    double spreading_s_ = 10.0;
+    // half width of the cos-2s directions around mean_direction_ (the h5 headings have to cover them)
+    double spreading_range_ = 180.0;
+    // user spreading table (directions and weights, normalized to a sum of 1), used instead of cos-2s if not empty
+    std::vector<double> spreading_directions_;
+    std::vector<double> spreading_weights_;
+    // destination of the spectrum ("spectral_densities") and precomputed free surface elevation ("eta") series, text
+    // files in the working directory by default. A NullDiagnosticsSink (or nullptr) turns them off, a
+    // TextDiagnosticsSink with a per-run directory or an HDF5DiagnosticsSink avoids collisions between parallel runs,
+    // an AsyncDiagnosticsSink moves the writing off the setup
+    std::shared_ptr<DiagnosticsSink> diagnostics_ = std::make_shared<TextDiagnosticsSink>();
 };
 
 class IrregularWaves : public WaveBase {
@@ -301,6 +609,21 @@ class IrregularWaves : public WaveBase {
     std::vector<double> GetFreeSurfaceElevation();
     std::vector<double> GetEtaTimeData();
 
+    /**
+     * @brief Gets the free surface elevation series convolved with the excitation IRF of a body.
+     *
+     * @param body index of the body
+     *
+     * @return elevation at the reference position of the body (see IrregularWaveParams::eta_reference_positions_),
+     * or the shared series at the origin without reference positions, sampled at GetFreeSurfaceTime()
+     */
+    std::vector<double> GetFreeSurfaceElevation(int body);
+
+    /**
+     * @brief Gets the times of the precomputed free surface elevation series.
+     */
+    std::vector<double> GetFreeSurfaceTime();
+
     Eigen::VectorXd GetForceAtTime(double t) override;
 
     /**
@@ -361,12 +684,29 @@ class IrregularWaves : public WaveBase {
     /**
      * @brief Initializes other member variables for timestep calculations later.
      *
-     * Links the HydroData::IrregularWaveInfo chunk to IrregularWave for use in calculations.
+     * Links the shared HydroData to IrregularWave for use in calculations (the data is not copied).
      * Should be called before Initialize().
      *
-     * @param irreg_h5_data reference to chunk of h5 data needed for IrregularWave calculations
+     * @param hydro_data shared h5 data, the HydroData::IrregularWaveInfo chunk is used for IrregularWave calculations
+     */
+    void AddH5Data(std::shared_ptr<const HydroData> hydro_data);
+
+    /**
+     * @brief Creates another realization of the same sea state, with the random phases of another seed.
+     *
+     * The spectrum, wave numbers, directions and excitation IRFs are shared with (copied from) this wave, only the
+     * phases and what depends on them (free surface elevation, precomputed excitation force, frequency domain
+     * excitation coefficients) are computed. The realization is the same as an IrregularWaves set up with seed_ =
+     * seed. Thread safe: several realizations can be created from the same wave at the same time. The realization
+     * does not write diagnostics (IrregularWaveParams::diagnostics_ is null), as the sink would be shared.
+     *
+     * @param seed seed of the random phases
+     *
+     * @return realization, ready for GetForceAtTime() and the kinematics
+     *
+     * @exception std::runtime_error if the wave was not set up from a spectrum by AddH5Data()
      */
-    void AddH5Data(std::vector<HydroData::IrregularWaveInfo>& irreg_h5_data, HydroData::SimulationParameters& sim_data);
+    std::shared_ptr<IrregularWaves> CreateRealization(int seed) const;
 
     double GetElevation(const Eigen::Vector3d& position, double time) override;
 
@@ -374,21 +714,57 @@ class IrregularWaves : public WaveBase {
 
     Eigen::Vector3d GetAcceleration(const Eigen::Vector3d& position, double time) override;
 
+    void GetElevations(const Eigen::MatrixX3d& positions, double time, Eigen::VectorXd& elevations) override;
+
+    void GetVelocities(const Eigen::MatrixX3d& positions, double time, Eigen::MatrixX3d& velocities) override;
+
+    void GetAccelerations(const Eigen::MatrixX3d& positions, double time, Eigen::MatrixX3d& accelerations) override;
+
+    /**
+     * @brief Computes the elevation, velocity and acceleration with one evaluation of the component phases.
+     *
+     * The elevation used for Wheeler stretching is the returned elevation, and the depth factors at the stretched
+     * depth are shared by the velocity and acceleration.
+     */
+    WaveKinematics GetKinematics(const Eigen::Vector3d& position, double time) override;
+
   private:
+    friend class IrregularWaveEnsemble;
+
     IrregularWaveParams params_;
     std::vector<double> spectrum_;
     std::vector<double> time_data_;
     std::vector<double> free_surface_elevation_sampled_;
+    // one series per body at IrregularWaveParams::eta_reference_positions_, empty if there are none
+    std::vector<std::vector<double>> body_free_surface_elevation_sampled_;
+    // excitation IRF time range of all bodies
+    double irf_time_min_ = 0.0;
+    double irf_time_max_ = 0.0;
+    // start of the elevation series and of its ramp. Streaming: sample n of the elevation is at eta_time_origin_ +
+    // n eta_dt_, the window starts at sample window_first_index_
+    double eta_time_origin_    = 0.0;
+    double eta_dt_             = 0.0;
+    size_t window_first_index_ = 0;
     std::vector<double> free_surface_time_sampled_;
-    bool spectrumCreated_;
+    bool spectrumCreated_ = false;
 
     const WaveMode mode_ = WaveMode::irregular;
     // unsigned int num_bodies_;
     // const WaveMode mode_ = WaveMode::irregular;
-    std::vector<HydroData::IrregularWaveInfo> wave_info_;
-    std::vector<Eigen::MatrixXd> ex_irf_sampled_;
-    std::vector<Eigen::VectorXd> ex_irf_time_sampled_;
+    std::shared_ptr<const HydroData> hydro_data_;
+    // views into hydro_data_ when the h5 data already holds the IRF at the simulation time step, own copies otherwise
+    std::vector<std::shared_ptr<const Eigen::MatrixXd>> ex_irf_sampled_;
+    std::vector<std::shared_ptr<const Eigen::VectorXd>> ex_irf_time_sampled_;
     std::vector<Eigen::VectorXd> ex_irf_width_sampled_;
+    // IRF times integration width, one column of the 6 dofs per IRF sample, shared with the h5 data cache (and the
+    // realizations of an ensemble) when resampled
+    std::vector<std::shared_ptr<const Eigen::MatrixXd>> ex_irf_weighted_;
+    // free surface elevation at the IRF samples of the current convolution
+    Eigen::VectorXd convolution_eta_buffer_;
+    // precompute_excitation_force_: force of the 6 dofs of each body at force_series_start_ + n force_series_dt_
+    std::vector<Eigen::Matrix<double, 6, Eigen::Dynamic>> force_series_;
+    std::vector<double> force_series_start_;
+    std::vector<double> force_series_dt_;
     Eigen::VectorXd spectrum_frequencies_;
     Eigen::VectorXd spectral_densities_;
     Eigen::VectorXd spectral_widths_;
@@ -396,37 +772,174 @@ class IrregularWaves : public WaveBase {
     Eigen::VectorXd wave_phases_;
     std::string mesh_file_name_;
 
+    // directions (rad) and weights of the directional spreading, a single direction for long-crested seas
+    Eigen::VectorXd direction_angles_;
+    Eigen::VectorXd direction_weights_;
+    bool directional_ = false;
+    // excitation force synthesized from excitation_coef_re_/im_ instead of the IRF convolution
+    bool frequency_domain_force_ = false;
+
+    // per component constants of the kinematics, precomputed in CreateSpectrum(). Component c = i nd + j has the
+    // frequency i and direction j (nd directions), with the random phase wave_phases_[c]
+    Eigen::ArrayXd component_amplitudes_;  // sqrt(2 S(f) df D(theta))
+    Eigen::ArrayXd component_omegas_;      // 2 pi f
+    Eigen::ArrayXd component_wavenumbers_;
+    Eigen::ArrayXd component_wavenumbers_x_;  // k cos(theta)
+    Eigen::ArrayXd component_wavenumbers_y_;  // k sin(theta)
+    Eigen::ArrayXd component_cos_directions_;
+    Eigen::ArrayXd component_sin_directions_;
+    Eigen::ArrayXd omega_amplitudes_;   // omega A, velocity amplitude
+    Eigen::ArrayXd omega2_amplitudes_;  // omega^2 A, acceleration amplitude
+    // cosh/sinh(k (z + d)) / sinh(k d) = exp(k z) (1 +/- exp(-2 k (z + d))) / (1 - exp(-2 k d)) in shallow water,
+    // exp(k z) in deep water (2 pi / k > d or k d > 500)
+    Eigen::Array<bool, Eigen::Dynamic, 1> shallow_water_;
+    Eigen::ArrayXd inv_depth_denominators_;
+    // phi_c - omega_c t of the last evaluation time, shared by all points
+    Eigen::ArrayXd time_phases_;
+    Eigen::ArrayXd cos_buffer_;
+    Eigen::ArrayXd sin_buffer_;
+    Eigen::ArrayXd horizontal_buffer_;
+    Eigen::ArrayXd vertical_buffer_;
+
+    /**
+     * @brief Computes the time dependent part phi_c - omega_c t of the component phases.
+     */
+    void SetTimePhases(double time);
+
+    // excitation of directional seas, sum over the directions of each frequency: the force of dof d is
+    // sum_i coef_re(d, i) cos(omega_i t) - coef_im(d, i) sin(omega_i t)
+    Eigen::ArrayXd spectrum_omegas_;
+    Eigen::MatrixXd excitation_coef_re_;
+    Eigen::MatrixXd excitation_coef_im_;
+    Eigen::VectorXd force_;
+    Eigen::ArrayXd force_cos_buffer_;
+    Eigen::ArrayXd force_sin_buffer_;
+
+    /**
+     * @brief Computes cos and sin of k_c (x cos(theta_c) + y sin(theta_c)) - omega_c t + phi_c for all components
+     * into the buffers.
+     *
+     * Uses the time phases of the last SetTimePhases() call.
+     */
+    void ComputeComponentPhases(double x, double y);
+
+    /**
+     * @brief Sets the directions and weights of the directional spreading from the parameters.
+     *
+     * @exception std::runtime_error if the spreading table is inconsistent
+     */
+    void CreateDirections();
+
+    /**
+     * @brief Sums the components of each frequency over the directions at a position.
+     *
+     * @return complex amplitude Z_i of each frequency, the elevation at the position is sum_i Re(Z_i exp(i omega_i t))
+     */
+    Eigen::VectorXcd GetFrequencyAmplitudes(const Eigen::Vector3d& position) const;
+
+    /**
+     * @brief Computes the excitation coefficients of a directional sea from the h5 excitation magnitude and phase.
+     *
+     * Interpolated in heading and frequency like RegularWave, frequencies outside of the h5 frequencies use the
+     * closest h5 frequency.
+     *
+     * @exception std::runtime_error if a direction is outside of the h5 headings
+     */
+    void ComputeExcitationCoefficients();
+
+    /**
+     * @brief Computes the horizontal and vertical decay of the kinematics of each component with depth.
+     */
+    void ComputeDepthFactors(double z, Eigen::ArrayXd& horizontal, Eigen::ArrayXd& vertical) const;
+
+    /**
+     * @brief Computes the elevation, velocity and acceleration at a point at the time of the last SetTimePhases()
+     * call, from a single evaluation of the component phases.
+     */
+    WaveKinematics ComputeKinematics(const Eigen::Vector3d& position);
+
+    /**
+     * @brief Links the h5 data and sets up the seed independent part of the waves (IRFs, spectrum, wave numbers, or
+     * the eta file), without the realization of a spectrum.
+     */
+    void SetUpSeaState(std::shared_ptr<const HydroData> hydro_data);
+
+    /**
+     * @brief Computes what depends on the random phases of a spectrum: free surface elevation, precomputed
+     * excitation force and frequency domain excitation coefficients.
+     */
+    void InitializeRealization();
+
+    /**
+     * @brief Draws wave_phases_ (already sized) from params_.seed_.
+     */
+    void CreateWavePhases();
+
     void InitializeIRFVectors();
     void ReadEtaFromFile();
     void CreateFreeSurfaceElevation();
 
-    Eigen::MatrixXd GetExcitationIRF(int b) const;
+    /**
+     * @brief Computes the free surface elevation of the spectrum at a position on a uniform time grid.
+     *
+     * @param position position of the elevation
+     * @param times uniformly spaced times
+     *
+     * @return elevation at the times, without ramp
+     */
+    std::vector<double> SynthesizeEta(const Eigen::Vector3d& position, const std::vector<double>& times) const;
+
+    /**
+     * @brief Applies the ramp_duration_ ramp to elevation samples, linear in time from eta_time_origin_.
+     *
+     * @param times increasing times of the samples
+     * @param eta elevation samples
+     */
+    void ApplyRamp(const std::vector<double>& times, std::vector<double>& eta) const;
+
+    /**
+     * @brief Streaming: generates the next blocks of the free surface elevation until the window covers the excitation
+     * IRF at the given time, and drops the samples that are no longer needed.
+     */
+    void AdvanceFreeSurfaceWindow(double time);
+
+    /**
+     * @brief Computes the excitation force series of every body by FFT convolution of the free surface elevation
+     * with the excitation IRF (precompute_excitation_force_).
+     *
+     * The force is computed on the IRF time step over the times where the whole IRF overlaps the elevation, with the
+     * elevation linearly interpolated as in ExcitationConvolution().
+     *
+     * @exception std::runtime_error if an IRF is not uniformly sampled
+     */
+    void PrecomputeExcitationForce();
 
-    /** @brief Resamples IRF time, widths, and values.
+    /** @brief Resamples IRF time, widths, and values (cached in the h5 data, see
+     * HydroData::GetResampledExcitationIRF()).
      *
      * @param dt Time step value to resample
      */
     void ResampleIRF(double dt);
 
-    /** @brief Calculates width (used for excitation convolution).
+    /** @brief Calculates width and weighted IRF (used for excitation convolution) of IRFs that are not resampled.
      */
     void CalculateWidthIRF();
 
     /**
-     * @brief Calculates the component of force from Convolution integral for specified body, dof, time.
+     * @brief Calculates the force from Convolution integral for all 6 dofs of the specified body at a time.
      *
      * The discretization uses the time series of the of the IRF relative to the current time step.
      * Linear interpolation is done for the free surface elevation if time_sim-time_irf is between two
      * values of the time series of the precomputed free surface elevation.
      * Trapezoidal integration is used to compute the force.
+     * The elevation is interpolated once per IRF sample and shared by the 6 dofs.
      *
      * @param body which body currently calculating for
-     * @param dof which degree of freedom to calculate force value for
      * @param time the time to compute force for
      *
-     * @return value of force vector at t time in component corresponding to body and dof
+     * @return force of the 6 dofs of the body at t time
      */
-    double ExcitationConvolution(int body, int dof, double time);
+    Eigen::Matrix<double, 6, 1> ExcitationConvolution(int body, double time);
 };
 
 /**
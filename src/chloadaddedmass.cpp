@@ -5,23 +5,31 @@
  *********************************************************************/
 #include <hydroc/chloadaddedmass.h>
 
+#include <stdexcept>
 #include <utility>
 
 #include "chrono/physics/ChBody.h"
 
-ChLoadAddedMass::ChLoadAddedMass(const std::vector<HydroData::BodyInfo>& user_h5_body_data,
+ChLoadAddedMass::ChLoadAddedMass(std::shared_ptr<const HydroData> hydro_data,
                                  std::vector<std::shared_ptr<ChLoadable>>& bodies,
                                  ChSystem* system)
-    : ChLoadCustomMultiple(bodies), system(system) {
-    auto nBodies = bodies.size();
-
-    infinite_added_mass.setZero(6 * nBodies, 6 * nBodies);
-    for (int i = 0; i < nBodies; i++) {
-        infinite_added_mass.block(i * 6, 0, 6, nBodies * 6) = user_h5_body_data[i].inf_added_mass;
+    : ChLoadCustomMultiple(bodies), system(system), hydro_data_(std::move(hydro_data)), num_bodies_(bodies.size()) {
+    if (hydro_data_ == nullptr || hydro_data_->GetNumBodies() < num_bodies_) {
+        throw std::runtime_error("Added mass: hydro data does not contain data for all bodies.");
     }
 
     // initialize added mass matrix for whole system
-    infinite_added_mass_system = infinite_added_mass;
+    AssembleSystemMatrix(6 * num_bodies_);
+}
+
+void ChLoadAddedMass::AssembleSystemMatrix(int size) {
+    infinite_added_mass_system.setZero(size, size);
+    const auto& body_infos = hydro_data_->GetBodyInfos();
+    for (int i = 0; i < num_bodies_; i++) {
+        for (int c = 0; c < num_bodies_; c++) {
+            infinite_added_mass_system.block(i * 6, c * 6, 6, 6) = *body_infos[i].inf_added_mass_blocks[c];
+        }
+    }
 }
 
 void ChLoadAddedMass::ComputeJacobian(ChState* state_x,       ///< state position to evaluate jacobians
@@ -39,9 +47,7 @@ void ChLoadAddedMass::ComputeJacobian(ChState* state_x,       ///< state positio
     // check if ChSystem mass matrix size different from added mass matrix size
     if (mmrows != infinite_added_mass_system.rows() && mmrows > 0) {
         // initialize/update system matrix;
-        infinite_added_mass_system.setZero(mmrows, mmrows);
-        auto amrows                                            = infinite_added_mass.rows();
-        infinite_added_mass_system.block(0, 0, amrows, amrows) = infinite_added_mass;
+        AssembleSystemMatrix(mmrows);
     }
     // set mass matrix here
     jacobians->M = infinite_added_mass_system;
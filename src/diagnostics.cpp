@@ -0,0 +1,136 @@
+/*********************************************************************
+ * @file  diagnostics.cpp
+ *
+ * @brief implementation file of the diagnostics sinks.
+ *********************************************************************/
+#include <H5Cpp.h>
+#include <hydroc/diagnostics.h>
+#include <hydroc/wave_types.h>
+
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+TextDiagnosticsSink::TextDiagnosticsSink(std::string directory) : directory_(std::move(directory)) {}
+
+void TextDiagnosticsSink::WriteSeries(const std::string& name,
+                                      const std::vector<double>& x,
+                                      const std::vector<double>& y) {
+    auto file_name = (std::filesystem::path(directory_) / (name + ".txt")).generic_string();
+    try {
+        std::filesystem::create_directories(directory_);
+        WriteEtaFile(file_name, x, y);
+    } catch (const std::exception& e) {
+        std::cerr << "Unable to write diagnostics " << file_name << ": " << e.what() << std::endl;
+    }
+}
+
+HDF5DiagnosticsSink::HDF5DiagnosticsSink(std::string file_name, std::string group)
+    : file_name_(std::move(file_name)), group_(std::move(group)) {}
+
+void HDF5DiagnosticsSink::WriteSeries(const std::string& name,
+                                      const std::vector<double>& x,
+                                      const std::vector<double>& y) {
+    try {
+        if (x.size() != y.size()) {
+            throw std::runtime_error(std::to_string(x.size()) + " x values and " + std::to_string(y.size()) +
+                                     " y values");
+        }
+        H5::H5File file(file_name_, std::filesystem::exists(file_name_) ? H5F_ACC_RDWR : H5F_ACC_TRUNC);
+
+        // path of the dataset from the root, the missing groups of the path are created with the dataset. H5Lexists
+        // fails on a path with a missing group, so the path is checked level by level
+        std::string dataset_path;
+        bool exists = true;
+        auto append = [&](const std::string& part) {
+            dataset_path += dataset_path.empty() ? part : "/" + part;
+            exists = exists && H5Lexists(file.getId(), dataset_path.c_str(), H5P_DEFAULT) > 0;
+        };
+        std::stringstream path(group_);
+        std::string part;
+        while (std::getline(path, part, '/')) {
+            if (!part.empty()) {
+                append(part);
+            }
+        }
+        append(name);
+        if (exists) {
+            file.unlink(dataset_path);
+        }
+        H5::LinkCreatPropList link_properties;
+        link_properties.setCreateIntermediateGroup(true);
+
+        std::vector<double> values(2 * x.size());
+        for (size_t i = 0; i < x.size(); i++) {
+            values[2 * i]     = x[i];
+            values[2 * i + 1] = y[i];
+        }
+        hsize_t dims[2] = {x.size(), 2};
+        H5::DataSpace space(2, dims);
+        file.createDataSet(dataset_path, H5::PredType::NATIVE_DOUBLE, space, H5::DSetCreatPropList::DEFAULT,
+                           H5::DSetAccPropList::DEFAULT, link_properties)
+            .write(values.data(), H5::PredType::NATIVE_DOUBLE);
+    } catch (const H5::Exception& e) {
+        std::cerr << "Unable to write diagnostics " << name << " to " << file_name_ << ": " << e.getDetailMsg()
+                  << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Unable to write diagnostics " << name << " to " << file_name_ << ": " << e.what() << std::endl;
+    }
+}
+
+AsyncDiagnosticsSink::AsyncDiagnosticsSink(std::shared_ptr<DiagnosticsSink> sink) : sink_(std::move(sink)) {
+    worker_ = std::thread(&AsyncDiagnosticsSink::Run, this);
+}
+
+AsyncDiagnosticsSink::~AsyncDiagnosticsSink() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    queue_changed_.notify_all();
+    worker_.join();
+}
+
+void AsyncDiagnosticsSink::WriteSeries(const std::string& name,
+                                       const std::vector<double>& x,
+                                       const std::vector<double>& y) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back({name, x, y, false});
+    }
+    queue_changed_.notify_all();
+}
+
+void AsyncDiagnosticsSink::Flush() {
+    // the worker flushes the sink after the series queued before, in order
+    std::unique_lock<std::mutex> lock(mutex_);
+    queue_.push_back({"", {}, {}, true});
+    size_t flush = ++num_flushes_requested_;
+    queue_changed_.notify_all();
+    queue_changed_.wait(lock, [this, flush] { return num_flushes_done_ >= flush; });
+}
+
+void AsyncDiagnosticsSink::Run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        queue_changed_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+        // pending series are written before stopping
+        if (queue_.empty()) {
+            return;
+        }
+        Series series = std::move(queue_.front());
+        queue_.pop_front();
+        lock.unlock();
+        if (series.flush) {
+            sink_->Flush();
+        } else {
+            sink_->WriteSeries(series.name, series.x, series.y);
+        }
+        lock.lock();
+        if (series.flush) {
+            num_flushes_done_++;
+            queue_changed_.notify_all();
+        }
+    }
+}
@@ -0,0 +1,115 @@
+/*********************************************************************
+ * @file  dispersion.cpp
+ *
+ * @brief implementation file of DispersionSolver.
+ *********************************************************************/
+#include <hydroc/dispersion.h>
+#include <hydroc/helper.h>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+DispersionSolver::DispersionSolver(double water_depth, double g) : water_depth_(water_depth), g_(g) {
+    if (water_depth <= 0.0 || g <= 0.0) {
+        throw std::runtime_error("Cannot compute wavenumber with water depth: " + std::to_string(water_depth) +
+                                 " and g: " + std::to_string(g) + ".");
+    }
+}
+
+std::shared_ptr<const DispersionSolver> DispersionSolver::Get(double water_depth, double g) {
+    static std::mutex solvers_mutex;
+    static std::map<std::pair<double, double>, std::shared_ptr<const DispersionSolver>> solvers;
+
+    std::lock_guard<std::mutex> lock(solvers_mutex);
+    auto& solver = solvers[{water_depth, g}];
+    if (solver == nullptr) {
+        solver = std::make_shared<const DispersionSolver>(water_depth, g);
+    }
+    return solver;
+}
+
+double DispersionSolver::GetWaveNumber(double omega) const {
+    return GetWaveNumbers(Eigen::VectorXd::Constant(1, omega))[0];
+}
+
+Eigen::VectorXd DispersionSolver::GetWaveNumbers(const Eigen::VectorXd& omegas, int num_threads) const {
+    Eigen::VectorXd wavenumbers(omegas.size());
+    auto by_omega = [](const TableEntry& entry, double omega) { return entry.first < omega; };
+
+    // frequencies already in the table
+    std::vector<Eigen::Index> missing;
+    {
+        std::lock_guard<std::mutex> lock(table_mutex_);
+        for (Eigen::Index i = 0; i < omegas.size(); i++) {
+            auto entry = std::lower_bound(table_.begin(), table_.end(), omegas[i], by_omega);
+            if (entry != table_.end() && entry->first == omegas[i]) {
+                wavenumbers[i] = entry->second;
+            } else {
+                missing.push_back(i);
+            }
+        }
+    }
+    if (missing.empty()) {
+        return wavenumbers;
+    }
+
+    Eigen::ArrayXd missing_omegas(missing.size());
+    for (size_t i = 0; i < missing.size(); i++) {
+        missing_omegas[i] = omegas[missing[i]];
+    }
+    Eigen::ArrayXd solved = Solve(missing_omegas, num_threads);
+    for (size_t i = 0; i < missing.size(); i++) {
+        wavenumbers[missing[i]] = solved[i];
+    }
+
+    // insert into the sorted table, frequencies solved meanwhile by another thread are kept once. Batches larger than
+    // the table only keep their last frequencies
+    std::lock_guard<std::mutex> lock(table_mutex_);
+    for (size_t i = 0; i < missing.size(); i++) {
+        auto entry = std::lower_bound(table_.begin(), table_.end(), missing_omegas[i], by_omega);
+        if (entry != table_.end() && entry->first == missing_omegas[i]) {
+            continue;
+        }
+        if (table_.size() >= kMaxTableSize) {
+            table_.clear();
+            entry = table_.end();
+        }
+        table_.insert(entry, {missing_omegas[i], solved[i]});
+    }
+    return wavenumbers;
+}
+
+Eigen::ArrayXd DispersionSolver::Solve(const Eigen::ArrayXd& omegas, int num_threads) const {
+    Eigen::ArrayXd wavenumbers(omegas.size());
+    hydroc::ParallelFor(omegas.size(), num_threads, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            // y = omega^2 d / g, solve x tanh(x) = y for x = k d
+            double y = omegas[i] * omegas[i] * water_depth_ / g_;
+            if (y <= 0.0) {
+                wavenumbers[i] = 0.0;
+                continue;
+            }
+
+            // Fenton and McKee (1990) explicit approximation, y^(3/4) and coth^(2/3) without pow
+            double coth = 1.0 / std::tanh(std::sqrt(y * std::sqrt(y)));
+            double x    = y * std::cbrt(coth * coth);
+
+            const int max_iterations = 20;
+            for (int iteration = 0; iteration < max_iterations; iteration++) {
+                double tanh_x = std::tanh(x);
+                double delta  = (x * tanh_x - y) / (tanh_x + x * (1.0 - tanh_x * tanh_x));
+                x -= delta;
+                if (std::abs(delta) <= 1e-14 * x) {
+                    break;
+                }
+            }
+            wavenumbers[i] = x / water_depth_;
+        }
+    });
+    return wavenumbers;
+}
@@ -0,0 +1,140 @@
+/*********************************************************************
+ * @file  frequency_domain.cpp
+ *
+ * @brief implementation file of FrequencyDomainSolver.
+ *********************************************************************/
+#include <hydroc/frequency_domain.h>
+
+#include <algorithm>
+#include <complex>
+#include <stdexcept>
+#include <string>
+
+FrequencyDomainSolver::FrequencyDomainSolver(std::shared_ptr<const HydroData> hydro_data,
+                                             const Eigen::MatrixXd& mass_matrix)
+    : hydro_data_(std::move(hydro_data)) {
+    if (hydro_data_ == nullptr || !hydro_data_->HasFrequencyDependentRadiation()) {
+        throw std::runtime_error(
+            "Frequency domain solver needs the frequency dependent added mass and radiation damping (added_mass/all "
+            "and radiation_damping/all) of every body.");
+    }
+    int num_bodies = hydro_data_->GetNumBodies();
+    num_dofs_      = 6 * num_bodies;
+    if (mass_matrix.rows() != num_dofs_ || mass_matrix.cols() != num_dofs_) {
+        throw std::runtime_error("Frequency domain solver: mass matrix has to be " + std::to_string(num_dofs_) + " x " +
+                                 std::to_string(num_dofs_) + ".");
+    }
+    mass_matrix_ = mass_matrix;
+
+    // hydrostatic stiffness of each body, same as the restoring force in TestHydro::ComputeForceHydrostatics()
+    const double rho = hydro_data_->GetRhoVal();
+    const double g   = hydro_data_->GetSimulationInfo().g;
+    hydrostatic_stiffness_.setZero(num_dofs_, num_dofs_);
+    for (int b = 0; b < num_bodies; b++) {
+        hydrostatic_stiffness_.block(6 * b, 6 * b, 6, 6) = rho * g * hydro_data_->GetLinMatrix(b);
+    }
+
+    pto_damping_.setZero(num_dofs_, num_dofs_);
+    pto_stiffness_.setZero(num_dofs_, num_dofs_);
+    for (int i = 0; i < num_dofs_; i++) {
+        active_dofs_.push_back(i);
+    }
+}
+
+void FrequencyDomainSolver::SetPTO(const Eigen::MatrixXd& damping, const Eigen::MatrixXd& stiffness) {
+    if (damping.rows() != num_dofs_ || damping.cols() != num_dofs_ || stiffness.rows() != num_dofs_ ||
+        stiffness.cols() != num_dofs_) {
+        throw std::runtime_error("Frequency domain solver: PTO matrices have to be " + std::to_string(num_dofs_) +
+                                 " x " + std::to_string(num_dofs_) + ".");
+    }
+    pto_damping_   = damping;
+    pto_stiffness_ = stiffness;
+}
+
+void FrequencyDomainSolver::SetActiveDofs(const std::vector<int>& dofs) {
+    for (int dof : dofs) {
+        if (dof < 0 || dof >= num_dofs_) {
+            throw std::runtime_error("Frequency domain solver: dof " + std::to_string(dof) + " out of range.");
+        }
+    }
+    active_dofs_ = dofs;
+    std::sort(active_dofs_.begin(), active_dofs_.end());
+    active_dofs_.erase(std::unique(active_dofs_.begin(), active_dofs_.end()), active_dofs_.end());
+}
+
+FrequencyDomainResults FrequencyDomainSolver::Solve(const Eigen::VectorXd& omegas, double wave_heading) const {
+    const std::complex<double> i_unit(0.0, 1.0);
+    const int num_active = active_dofs_.size();
+
+    // the second index of the excitation coefficients is the wave heading, same for all frequencies
+    HeadingInterp heading = GetHeadingInterp(hydro_data_->GetSimulationInfo().wave_headings, wave_heading);
+
+    FrequencyDomainResults results;
+    results.omegas = omegas;
+    results.response.setZero(num_dofs_, omegas.size());
+    results.pto_power.setZero(omegas.size());
+
+    Eigen::MatrixXd added_mass, damping;
+    Eigen::VectorXcd excitation;
+    Eigen::MatrixXcd impedance(num_active, num_active);
+    Eigen::VectorXcd force(num_active);
+    for (int k = 0; k < omegas.size(); k++) {
+        double omega = omegas[k];
+        InterpolateCoefficients(omega, heading, added_mass, damping, excitation);
+
+        // equation of motion of the free dofs
+        for (int r = 0; r < num_active; r++) {
+            int row  = active_dofs_[r];
+            force[r] = excitation[row];
+            for (int c = 0; c < num_active; c++) {
+                int col = active_dofs_[c];
+                impedance(r, c) =
+                    -omega * omega * (mass_matrix_(row, col) + added_mass(row, col)) +
+                    i_unit * omega * (damping(row, col) + pto_damping_(row, col)) +
+                    (hydrostatic_stiffness_(row, col) + pto_stiffness_(row, col));
+            }
+        }
+        Eigen::VectorXcd response = impedance.partialPivLu().solve(force);
+
+        Eigen::VectorXcd velocity = Eigen::VectorXcd::Zero(num_dofs_);
+        for (int r = 0; r < num_active; r++) {
+            results.response(active_dofs_[r], k) = response[r];
+            velocity[active_dofs_[r]]            = i_unit * omega * response[r];
+        }
+
+        // mean absorbed power 1/2 Re(v^H B_pto v)
+        results.pto_power[k] = 0.5 * velocity.dot(pto_damping_.cast<std::complex<double>>() * velocity).real();
+    }
+
+    return results;
+}
+
+void FrequencyDomainSolver::InterpolateCoefficients(double omega,
+                                                    const HeadingInterp& heading,
+                                                    Eigen::MatrixXd& added_mass,
+                                                    Eigen::MatrixXd& damping,
+                                                    Eigen::VectorXcd& excitation) const {
+    // shared with RegularWave, handles non-uniform frequency lists
+    FrequencyTable::Interp freq = hydro_data_->GetFrequencyTable().Lookup(omega);
+    int idx                     = freq.index;
+    double weight               = freq.weight;
+    int idx_upper               = weight > 0.0 ? idx + 1 : idx;
+
+    added_mass.resize(num_dofs_, num_dofs_);
+    damping.resize(num_dofs_, num_dofs_);
+    excitation.resize(num_dofs_);
+    for (int b = 0; b < hydro_data_->GetNumBodies(); b++) {
+        added_mass.middleRows(6 * b, 6) = (1.0 - weight) * hydro_data_->GetAddedMassMatrix(b, idx) +
+                                          weight * hydro_data_->GetAddedMassMatrix(b, idx_upper);
+        damping.middleRows(6 * b, 6)    = (1.0 - weight) * hydro_data_->GetRadiationDampingMatrix(b, idx) +
+                                       weight * hydro_data_->GetRadiationDampingMatrix(b, idx_upper);
+
+        // same excitation as RegularWave
+        const auto& reg = hydro_data_->GetRegularWaveInfos()[b];
+        for (int dof = 0; dof < 6; dof++) {
+            double mag, phase;
+            InterpolateExcitation(reg, dof, heading, freq, mag, phase);
+            excitation[6 * b + dof] = std::polar(mag, phase);
+        }
+    }
+}
@@ -7,14 +7,191 @@
 // TODO: this include statement list looks good
 #include <H5Cpp.h>
 #include <hydroc/h5fileinfo.h>
+#include <unsupported/Eigen/Splines>
+#include <algorithm>
+#include <cmath>
 #include <filesystem>  // std::filesystem::absolute
+#include <map>
 
 using namespace chrono;  // TODO narrow this using namespace to specify what we use from chrono or put chrono:: in front
                          // of it all?
 
-H5FileInfo::H5FileInfo(std::string file, int num_bod) {
+namespace {
+
+bool SameShape(const Eigen::MatrixXd& a, const Eigen::MatrixXd& b) {
+    return a.rows() == b.rows() && a.cols() == b.cols();
+}
+
+bool SameShape(const Eigen::Tensor<double, 3>& a, const Eigen::Tensor<double, 3>& b) {
+    return a.dimensions() == b.dimensions();
+}
+
+template <typename T>
+double MaxAbs(const T& block) {
+    double max_abs = 0.0;
+    for (int64_t i = 0; i < block.size(); i++) {
+        max_abs = std::max(max_abs, std::abs(block.data()[i]));
+    }
+    return max_abs;
+}
+
+// keeps one copy of each distinct coefficient block, candidates are looked up by their largest absolute value
+template <typename T>
+class CoefficientPool {
+  public:
+    explicit CoefficientPool(double tolerance) : tolerance_(tolerance) {}
+
+    // returns the pooled block identical to block (within tolerance), or adds block to the pool
+    std::shared_ptr<const T> Share(const std::shared_ptr<const T>& block) {
+        if (block == nullptr) {
+            return block;
+        }
+        double scale = MaxAbs(*block);
+        // max|a - b| <= tolerance * max(max|a|, max|b|) requires max|b| within these bounds
+        double lower = scale * (1.0 - tolerance_);
+        double upper = tolerance_ < 1.0 ? scale / (1.0 - tolerance_) : std::numeric_limits<double>::infinity();
+        for (auto it = blocks_.lower_bound(lower); it != blocks_.end() && it->first <= upper; ++it) {
+            if (it->second == block) {
+                return block;
+            }
+            if (IsClose(*it->second, *block, tolerance_ * std::max(it->first, scale))) {
+                num_shared_++;
+                return it->second;
+            }
+        }
+        blocks_.emplace(scale, block);
+        return block;
+    }
+
+    int GetNumShared() const { return num_shared_; }
+
+  private:
+    double tolerance_;
+    int num_shared_ = 0;
+    std::multimap<double, std::shared_ptr<const T>> blocks_;
+
+    static bool IsClose(const T& a, const T& b, double max_diff) {
+        if (!SameShape(a, b)) {
+            return false;
+        }
+        for (int64_t i = 0; i < a.size(); i++) {
+            if (std::abs(a.data()[i] - b.data()[i]) > max_diff) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+struct CoefficientPools {
+    explicit CoefficientPools(double tolerance) : matrices(tolerance), tensors(tolerance) {}
+    CoefficientPool<Eigen::MatrixXd> matrices;
+    CoefficientPool<Eigen::Tensor<double, 3>> tensors;
+
+    int GetNumShared() const { return matrices.GetNumShared() + tensors.GetNumShared(); }
+};
+
+// replaces the body's coefficient blocks by the pooled identical ones
+void ShareBodyCoefficients(HydroData::BodyInfo& body, HydroData::IrregularWaveInfo& irreg, CoefficientPools& pools) {
+    body.lin_matrix = pools.matrices.Share(body.lin_matrix);
+    for (auto& block : body.inf_added_mass_blocks) {
+        block = pools.matrices.Share(block);
+    }
+    for (auto& block : body.rirf_blocks) {
+        block = pools.tensors.Share(block);
+    }
+    for (auto& block : body.added_mass_blocks) {
+        block = pools.tensors.Share(block);
+    }
+    for (auto& block : body.radiation_damping_blocks) {
+        block = pools.tensors.Share(block);
+    }
+    irreg.excitation_irf_matrix = pools.matrices.Share(irreg.excitation_irf_matrix);
+}
+
+// resampled IRF with its trapezoidal widths and weighted values
+std::shared_ptr<const HydroData::ResampledExcitationIRF> MakeResampledExcitationIRF(
+    std::shared_ptr<const Eigen::VectorXd> time,
+    std::shared_ptr<const Eigen::MatrixXd> values) {
+    auto resampled      = std::make_shared<HydroData::ResampledExcitationIRF>();
+    resampled->time     = std::move(time);
+    resampled->values   = std::move(values);
+    resampled->widths   = GetTrapezoidalWidths(*resampled->time);
+    resampled->weighted = std::make_shared<const Eigen::MatrixXd>(*resampled->values * resampled->widths.asDiagonal());
+    return resampled;
+}
+
+// selection of the first num_bod bodies and all frequencies
+HydroDataSelection SelectFirstBodies(int num_bod) {
+    HydroDataSelection selection;
+    for (int i = 0; i < num_bod; i++) {
+        selection.body_indices.push_back(i);
+    }
+    return selection;
+}
+}  // namespace
+
+FrequencyTable::FrequencyTable(const Eigen::VectorXd& omegas) : omegas_(omegas) {
+    int num_freqs = omegas_.size();
+    if (num_freqs == 0) {
+        throw std::runtime_error("Frequency table needs at least one frequency.");
+    }
+    for (int k = 1; k < num_freqs; k++) {
+        if (!(omegas_[k] > omegas_[k - 1])) {
+            throw std::runtime_error("Frequencies of the frequency table are not increasing.");
+        }
+    }
+    if (num_freqs > 1) {
+        double delta = (omegas_[num_freqs - 1] - omegas_[0]) / (num_freqs - 1);
+        bool uniform   = true;
+        for (int k = 1; k < num_freqs - 1 && uniform; k++) {
+            uniform = std::abs(omegas_[k] - (omegas_[0] + k * delta)) <= 1e-6 * delta;
+        }
+        uniform_delta_ = uniform ? delta : 0.0;
+    }
+}
+
+FrequencyTable::Interp FrequencyTable::Lookup(double omega) const {
+    int num_freqs = omegas_.size();
+    double tol    = 1e-12 * std::max(1.0, std::abs(omegas_[num_freqs - 1]));
+    if (!(omega >= omegas_[0] - tol && omega <= omegas_[num_freqs - 1] + tol)) {
+        throw std::runtime_error("Frequency " + std::to_string(omega) + " is outside of the h5 frequencies [" +
+                                 std::to_string(omegas_[0]) + ", " + std::to_string(omegas_[num_freqs - 1]) + "].");
+    }
+    if (num_freqs == 1 || omega >= omegas_[num_freqs - 1]) {
+        return {num_freqs - 1, 0.0};
+    }
+
+    int index;
+    if (uniform_delta_ > 0.0) {
+        // guess from the spacing, corrected for round-off in the h5 frequencies
+        index = std::min(std::max(static_cast<int>((omega - omegas_[0]) / uniform_delta_), 0), num_freqs - 2);
+        if (omega < omegas_[index] && index > 0) {
+            index--;
+        } else if (omega >= omegas_[index + 1] && index < num_freqs - 2) {
+            index++;
+        }
+    } else {
+        index = std::upper_bound(omegas_.data(), omegas_.data() + num_freqs, omega) - omegas_.data() - 1;
+        index = std::min(std::max(index, 0), num_freqs - 2);
+    }
+    double weight = (omega - omegas_[index]) / (omegas_[index + 1] - omegas_[index]);
+    return {index, std::min(std::max(weight, 0.0), 1.0)};
+}
+
+H5FileInfo::H5FileInfo(std::string file, int num_bod) : H5FileInfo(file, SelectFirstBodies(num_bod)) {}
+
+H5FileInfo::H5FileInfo(std::string file, HydroDataSelection selection) : selection_(std::move(selection)) {
     h5_file_name_ = file;
-    num_bodies_   = num_bod;
+    num_bodies_   = selection_.body_indices.size();
+    for (int body_index : selection_.body_indices) {
+        if (body_index < 0) {
+            throw std::runtime_error("H5 selection: negative body index " + std::to_string(body_index) + ".");
+        }
+    }
+    if (selection_.omega_min > selection_.omega_max) {
+        throw std::runtime_error("H5 selection: omega_min is larger than omega_max.");
+    }
     std::cout << "searching for file: " << file << std::endl;
     if (std::filesystem::exists(file)) {
         std::cout << "found file at: " << std::filesystem::absolute(file) << std::endl;
@@ -28,20 +205,51 @@ HydroData H5FileInfo::ReadH5Data() {
     H5::H5File userH5File(h5_file_name_, H5F_ACC_RDONLY);
     HydroData data_to_init;
     data_to_init.resize(num_bodies_);
+    data_to_init.sim_data_.h5_file_name = h5_file_name_;
 
     // simparams first
     InitScalar(userH5File, "simulation_parameters/rho", data_to_init.sim_data_.rho);
     InitScalar(userH5File, "simulation_parameters/g", data_to_init.sim_data_.g);
     InitScalar(userH5File, "simulation_parameters/water_depth", data_to_init.sim_data_.water_depth);
+    if (userH5File.nameExists("simulation_parameters/wave_dir")) {
+        Init1D(userH5File, "simulation_parameters/wave_dir", data_to_init.sim_data_.wave_headings);
+    } else {
+        data_to_init.sim_data_.wave_headings = Eigen::VectorXd::Zero(1);
+    }
     double rho = data_to_init.sim_data_.rho;
     double g   = data_to_init.sim_data_.g;
 
+    // selected frequency range, frequency dependent data is only read for these
+    Eigen::VectorXd freq_list;
+    Init1D(userH5File, "simulation_parameters/w", freq_list);
+    int freq_start = 0;
+    while (freq_start < freq_list.size() && freq_list[freq_start] < selection_.omega_min) {
+        freq_start++;
+    }
+    int freq_end = freq_start;
+    while (freq_end < freq_list.size() && freq_list[freq_end] <= selection_.omega_max) {
+        freq_end++;
+    }
+    int freq_count = freq_end - freq_start;
+    if (freq_count == 0) {
+        throw std::runtime_error("No frequencies in h5 file " + h5_file_name_ + " within the selected range [" +
+                                 std::to_string(selection_.omega_min) + ", " + std::to_string(selection_.omega_max) +
+                                 "].");
+    }
+    freq_list = freq_list.segment(freq_start, freq_count).eval();
+    data_to_init.frequency_table_ = FrequencyTable(freq_list);
+
+    // bit-identical coefficient blocks (e.g. self terms of identical devices) are stored once
+    CoefficientPools pools(0.0);
+    std::vector<Eigen::Tensor<double, 3>> blocks;
+
     // for each body things
     for (int i = 0; i < num_bodies_; i++) {
         // body data
-        data_to_init.body_data_[i].body_name = "body" + std::to_string(i + 1);
+        int h5_body_num                      = selection_.body_indices[i];
+        data_to_init.body_data_[i].body_name = "body" + std::to_string(h5_body_num + 1);
         std::string bodyName                 = data_to_init.body_data_[i].body_name;  // shortcut for reading later
-        data_to_init.body_data_[i].body_num  = i;
+        data_to_init.body_data_[i].body_num  = h5_body_num;
 
         InitScalar(userH5File, bodyName + "/properties/disp_vol", data_to_init.body_data_[i].disp_vol);
         Init1D(userH5File, bodyName + "/hydro_coeffs/radiation_damping/impulse_response_fun/t",
@@ -53,27 +261,61 @@ HydroData H5FileInfo::ReadH5Data() {
 
         Init1D(userH5File, bodyName + "/properties/cg", data_to_init.body_data_[i].cg);
         Init1D(userH5File, bodyName + "/properties/cb", data_to_init.body_data_[i].cb);
-        Init2D(userH5File, bodyName + "/hydro_coeffs/linear_restoring_stiffness",
-               data_to_init.body_data_[i].lin_matrix);
-        Init2D(userH5File, bodyName + "/hydro_coeffs/added_mass/inf_freq", data_to_init.body_data_[i].inf_added_mass);
-        data_to_init.body_data_[i].inf_added_mass *= rho;
-        Init3D(userH5File, bodyName + "/hydro_coeffs/radiation_damping/impulse_response_fun/K",
-               data_to_init.body_data_[i].rirf_matrix);
-        // Init3D(userH5File, bodyName + "/hydro_coeffs/radiation_damping/all",
-        //       data_to_init.body_data[i].radiation_damping_matrix);
+        Eigen::MatrixXd lin_matrix;
+        Init2D(userH5File, bodyName + "/hydro_coeffs/linear_restoring_stiffness", lin_matrix);
+        data_to_init.body_data_[i].lin_matrix = std::make_shared<const Eigen::MatrixXd>(std::move(lin_matrix));
+        // coupling columns of the selected bodies only
+        InitCoupled(userH5File, bodyName + "/hydro_coeffs/added_mass/inf_freq", blocks);
+        for (auto& block : blocks) {
+            Eigen::MatrixXd inf_added_mass =
+                Eigen::Map<const Eigen::MatrixXd>(block.data(), block.dimension(0), block.dimension(1)) * rho;
+            data_to_init.body_data_[i].inf_added_mass_blocks.push_back(
+                std::make_shared<const Eigen::MatrixXd>(std::move(inf_added_mass)));
+        }
+        InitCoupled(userH5File, bodyName + "/hydro_coeffs/radiation_damping/impulse_response_fun/K", blocks);
+        for (auto& block : blocks) {
+            data_to_init.body_data_[i].rirf_blocks.push_back(
+                std::make_shared<const Eigen::Tensor<double, 3>>(std::move(block)));
+        }
+
+        // frequency dependent radiation coefficients of the selected frequencies (for frequency domain analysis)
+        std::string added_mass_name        = bodyName + "/hydro_coeffs/added_mass/all";
+        std::string radiation_damping_name = bodyName + "/hydro_coeffs/radiation_damping/all";
+        if (userH5File.nameExists(added_mass_name) && userH5File.nameExists(radiation_damping_name)) {
+            InitCoupled(userH5File, added_mass_name, blocks, freq_start, freq_count);
+            for (auto& block : blocks) {
+                Eigen::Tensor<double, 3> added_mass = block * block.constant(rho);
+                data_to_init.body_data_[i].added_mass_blocks.push_back(
+                    std::make_shared<const Eigen::Tensor<double, 3>>(std::move(added_mass)));
+            }
+            InitCoupled(userH5File, radiation_damping_name, blocks, freq_start, freq_count);
+            for (auto& block : blocks) {
+                // scale by rho * omega
+                for (int k = 0; k < freq_count; k++) {
+                    block.chip(k, 2) = block.chip(k, 2) * block.chip(k, 2).constant(rho * freq_list[k]);
+                }
+                data_to_init.body_data_[i].radiation_damping_blocks.push_back(
+                    std::make_shared<const Eigen::Tensor<double, 3>>(std::move(block)));
+            }
+        }
 
         // reg wave
-        Init1D(userH5File, "simulation_parameters/w", data_to_init.reg_wave_data_[i].freq_list);
-        Init3D(userH5File, bodyName + "/hydro_coeffs/excitation/mag",
-               data_to_init.reg_wave_data_[i].excitation_mag_matrix);
+        data_to_init.reg_wave_data_[i].freq_list = freq_list;
+        InitFrequencySlice(userH5File, bodyName + "/hydro_coeffs/excitation/mag", freq_start, freq_count,
+                           data_to_init.reg_wave_data_[i].excitation_mag_matrix);
+        if (data_to_init.reg_wave_data_[i].excitation_mag_matrix.dimension(1) !=
+            data_to_init.sim_data_.wave_headings.size()) {
+            throw std::runtime_error("Excitation coefficients of " + bodyName + " in " + h5_file_name_ +
+                                     " do not match the number of wave headings in simulation_parameters/wave_dir.");
+        }
 
         // scale by rho * g
         data_to_init.reg_wave_data_[i].excitation_mag_matrix =
             data_to_init.reg_wave_data_[i].excitation_mag_matrix *
             data_to_init.reg_wave_data_[i].excitation_mag_matrix.constant(rho * g);
-        Init3D(userH5File, bodyName + "/hydro_coeffs/excitation/phase",
-               data_to_init.reg_wave_data_[i]
-                   .excitation_phase_matrix);  // TODO does this also need to be scaled by rho * g?
+        InitFrequencySlice(userH5File, bodyName + "/hydro_coeffs/excitation/phase", freq_start, freq_count,
+                           data_to_init.reg_wave_data_[i]
+                               .excitation_phase_matrix);  // TODO does this also need to be scaled by rho * g?
 
         // irreg wave
         // Init3D(userH5File, bodyName + "/hydro_coeffs/excitation/re", excitation_re_matrix, re_dims);
@@ -84,8 +326,13 @@ HydroData H5FileInfo::ReadH5Data() {
         // TODO look up Eigen resize and map to make this temp conversion better
         Eigen::Tensor<double, 3> temp;
         Init3D(userH5File, bodyName + "/hydro_coeffs/excitation/impulse_response_fun/f", temp);
-        data_to_init.irreg_wave_data_[i].excitation_irf_matrix = SqueezeMid(temp);
-        data_to_init.irreg_wave_data_[i].excitation_irf_matrix *= rho * g;
+        data_to_init.irreg_wave_data_[i].excitation_irf_matrix =
+            std::make_shared<const Eigen::MatrixXd>(SqueezeMid(temp) * rho * g);
+
+        ShareBodyCoefficients(data_to_init.body_data_[i], data_to_init.irreg_wave_data_[i], pools);
+    }
+    if (pools.GetNumShared() > 0) {
+        std::cout << "Sharing " << pools.GetNumShared() << " identical coefficient blocks between bodies." << std::endl;
     }
 
     userH5File.close();
@@ -212,6 +459,98 @@ void H5FileInfo::Init3D(H5::H5File& file, std::string data_name, Eigen::Tensor<d
     delete[] temp;
 }
 
+std::vector<size_t> H5FileInfo::GetDims(H5::H5File& file, const std::string& data_name) {
+    H5::DataSet dataset     = file.openDataSet(data_name);
+    H5::DataSpace filespace = dataset.getSpace();
+    std::vector<hsize_t> dims(filespace.getSimpleExtentNdims());
+    filespace.getSimpleExtentDims(dims.data());
+    dataset.close();
+    return std::vector<size_t>(dims.begin(), dims.end());
+}
+
+void H5FileInfo::ReadHyperslab(H5::H5File& file,
+                               const std::string& data_name,
+                               const std::vector<size_t>& start,
+                               const std::vector<size_t>& count,
+                               std::vector<double>& var) {
+    H5::DataSet dataset     = file.openDataSet(data_name);
+    H5::DataSpace filespace = dataset.getSpace();
+    std::vector<hsize_t> dims(filespace.getSimpleExtentNdims());
+    filespace.getSimpleExtentDims(dims.data());
+    if (dims.size() != start.size() || dims.size() != count.size()) {
+        throw std::runtime_error("Dataset " + data_name + " has rank " + std::to_string(dims.size()) + ".");
+    }
+
+    std::vector<hsize_t> slab_start(start.begin(), start.end());
+    std::vector<hsize_t> slab_count(count.begin(), count.end());
+    size_t size = 1;
+    for (size_t d = 0; d < dims.size(); d++) {
+        if (slab_start[d] + slab_count[d] > dims[d]) {
+            throw std::runtime_error("Selection out of bounds in dimension " + std::to_string(d) + " of dataset " +
+                                     data_name + " (size " + std::to_string(dims[d]) + ").");
+        }
+        size *= slab_count[d];
+    }
+
+    // only the selected block is read from the file
+    filespace.selectHyperslab(H5S_SELECT_SET, slab_count.data(), slab_start.data());
+    H5::DataSpace mspace(slab_count.size(), slab_count.data());
+    var.resize(size);
+    dataset.read(var.data(), H5::PredType::NATIVE_DOUBLE, mspace, filespace);
+    dataset.close();
+}
+
+void H5FileInfo::InitCoupled(H5::H5File& file,
+                             const std::string& data_name,
+                             std::vector<Eigen::Tensor<double, 3>>& blocks,
+                             int depth_start,
+                             int depth_count) {
+    auto dims    = GetDims(file, data_name);
+    bool is_2d   = dims.size() == 2;
+    size_t rows  = dims[0];
+    size_t depth = is_2d ? 1 : (depth_count < 0 ? dims[2] - depth_start : depth_count);
+
+    blocks.resize(num_bodies_);
+    std::vector<double> temp;
+    for (int c = 0; c < num_bodies_; c++) {
+        // 6 coupling columns of selected body c
+        std::vector<size_t> start = {0, 6 * (size_t)selection_.body_indices[c]};
+        std::vector<size_t> count = {rows, 6};
+        if (!is_2d) {
+            start.push_back(depth_start);
+            count.push_back(depth);
+        }
+        ReadHyperslab(file, data_name, start, count, temp);
+        auto& block = blocks[c];
+        block.resize((int64_t)rows, 6, (int64_t)depth);
+        for (size_t i = 0; i < rows; i++) {
+            for (size_t j = 0; j < 6; j++) {
+                for (size_t k = 0; k < depth; k++) {
+                    block(i, j, k) = temp[k + depth * (j + i * 6)];
+                }
+            }
+        }
+    }
+}
+
+void H5FileInfo::InitFrequencySlice(H5::H5File& file,
+                                    const std::string& data_name,
+                                    int freq_start,
+                                    int freq_count,
+                                    Eigen::Tensor<double, 3>& var) {
+    auto dims = GetDims(file, data_name);
+    std::vector<double> temp;
+    ReadHyperslab(file, data_name, {0, 0, (size_t)freq_start}, {dims[0], dims[1], (size_t)freq_count}, temp);
+    var.resize((int64_t)dims[0], (int64_t)dims[1], (int64_t)freq_count);
+    for (size_t i = 0; i < dims[0]; i++) {
+        for (size_t j = 0; j < dims[1]; j++) {
+            for (int k = 0; k < freq_count; k++) {
+                var(i, j, k) = temp[k + freq_count * (j + i * dims[1])];
+            }
+        }
+    }
+}
+
 H5FileInfo::~H5FileInfo() {}
 
 // TODO check order of function definitions here matches order in .h file
@@ -222,26 +561,71 @@ void HydroData::resize(int num_bodies) {
 }
 
 Eigen::MatrixXd HydroData::GetInfAddedMassMatrix(int b) const {
-    return body_data_[b].inf_added_mass;
+    const auto& blocks = body_data_[b].inf_added_mass_blocks;
+    Eigen::MatrixXd inf_added_mass(6, 6 * blocks.size());
+    for (size_t c = 0; c < blocks.size(); c++) {
+        inf_added_mass.block(0, 6 * c, 6, 6) = *blocks[c];
+    }
+    return inf_added_mass;
+}
+
+Eigen::MatrixXd HydroData::GetAddedMassMatrix(int b, int freq_index) const {
+    return GetFrequencyDependentMatrix(body_data_[b].added_mass_blocks, freq_index);
+}
+
+Eigen::MatrixXd HydroData::GetRadiationDampingMatrix(int b, int freq_index) const {
+    return GetFrequencyDependentMatrix(body_data_[b].radiation_damping_blocks, freq_index);
+}
+
+bool HydroData::HasFrequencyDependentRadiation() const {
+    for (const auto& body : body_data_) {
+        if (body.added_mass_blocks.empty() || body.radiation_damping_blocks.empty()) {
+            return false;
+        }
+    }
+    return !body_data_.empty();
+}
+
+Eigen::MatrixXd HydroData::GetFrequencyDependentMatrix(
+    const std::vector<std::shared_ptr<const Eigen::Tensor<double, 3>>>& blocks,
+    int freq_index) const {
+    if (blocks.empty()) {
+        throw std::runtime_error("No frequency dependent added mass and radiation damping in h5 file " +
+                                 sim_data_.h5_file_name + ".");
+    }
+    Eigen::MatrixXd matrix(6, 6 * blocks.size());
+    for (size_t c = 0; c < blocks.size(); c++) {
+        for (int i = 0; i < 6; i++) {
+            for (int j = 0; j < 6; j++) {
+                matrix(i, 6 * c + j) = (*blocks[c])(i, j, freq_index);
+            }
+        }
+    }
+    return matrix;
 }
 
 double HydroData::GetHydrostaticStiffnessVal(int b, int i, int j) const {
-    return body_data_[b].lin_matrix(i, j) * sim_data_.rho * sim_data_.g;
+    return (*body_data_[b].lin_matrix)(i, j) * sim_data_.rho * sim_data_.g;
 }
 
-Eigen::MatrixXd HydroData::GetLinMatrix(int b) const {
-    return body_data_[b].lin_matrix;
+const Eigen::MatrixXd& HydroData::GetLinMatrix(int b) const {
+    return *body_data_[b].lin_matrix;
 }
 
 double HydroData::GetRIRFVal(int b, int dof, int col, int s) const {
-    return body_data_[b].rirf_matrix(dof, col, s) * sim_data_.rho;  // scale radiation force by rho
+    // scale radiation force by rho
+    return (*body_data_[b].rirf_blocks[col / 6])(dof, col % 6, s) * sim_data_.rho;
 }
 
 int HydroData::GetRIRFDims(int i) const {
-    return body_data_[0].rirf_matrix.dimension(i);
+    const auto& blocks = body_data_[0].rirf_blocks;
+    if (i == 1) {
+        return 6 * blocks.size();
+    }
+    return blocks[0]->dimension(i);
 }
 
-Eigen::VectorXd HydroData::GetRIRFTimeVector() const {
+const Eigen::VectorXd& HydroData::GetRIRFTimeVector() const {
     double tol = 1e-10;
     // check if all time vectors are the same within tolerance
     auto& rirf_time_vector = body_data_[0].rirf_time_vector;
@@ -255,4 +639,141 @@ Eigen::VectorXd HydroData::GetRIRFTimeVector() const {
         }
     }
     return rirf_time_vector;
-}
\ No newline at end of file
+}
+
+void HydroData::SetExcitationIRF(int body,
+                                 const Eigen::VectorXd& time,
+                                 std::shared_ptr<const Eigen::MatrixXd> values) {
+    if (values == nullptr || values->rows() != 6 || values->cols() != time.size()) {
+        throw std::runtime_error("Excitation IRF of body " + std::to_string(body) +
+                                 " needs 6 rows and one column per time value.");
+    }
+    auto& irreg                 = irreg_wave_data_.at(body);
+    irreg.excitation_irf_time   = time;
+    irreg.excitation_irf_matrix = std::move(values);
+    excitation_irf_cache_.Clear();
+}
+
+void HydroData::ResampleExcitationIRF(double dt) {
+    if (dt <= 0.0) {
+        throw std::runtime_error("Cannot resample excitation IRF with time step: " + std::to_string(dt) + ".");
+    }
+    for (size_t b = 0; b < irreg_wave_data_.size(); b++) {
+        GetResampledExcitationIRF(b, dt);
+    }
+}
+
+size_t HydroData::GetExcitationIRFSource(int body) const {
+    // first body with the same IRF (see ShareIdenticalCoefficients()), its entry is shared
+    const auto& irreg = irreg_wave_data_.at(body);
+    size_t source     = 0;
+    while (source < static_cast<size_t>(body) &&
+           (irreg_wave_data_[source].excitation_irf_matrix != irreg.excitation_irf_matrix ||
+            irreg_wave_data_[source].excitation_irf_time.size() != irreg.excitation_irf_time.size() ||
+            irreg_wave_data_[source].excitation_irf_time != irreg.excitation_irf_time)) {
+        source++;
+    }
+    return source;
+}
+
+std::shared_ptr<const HydroData::ResampledExcitationIRF> HydroData::GetResampledExcitationIRF(int body,
+                                                                                               double dt) const {
+    if (dt <= 0.0) {
+        throw std::runtime_error("Cannot resample excitation IRF with time step: " + std::to_string(dt) + ".");
+    }
+    std::pair<size_t, double> key(GetExcitationIRFSource(body), dt);
+
+    // the first caller for the key fits the spline outside of the lock, the others wait for its result
+    std::promise<std::shared_ptr<const ResampledExcitationIRF>> promise;
+    ExcitationIRFCache::Entry entry;
+    {
+        std::lock_guard<std::mutex> lock(excitation_irf_cache_.mutex);
+        auto found = excitation_irf_cache_.entries.find(key);
+        if (found != excitation_irf_cache_.entries.end()) {
+            entry = found->second;
+        } else {
+            excitation_irf_cache_.entries.emplace(key, promise.get_future().share());
+        }
+    }
+    if (entry.valid()) {
+        return entry.get();
+    }
+
+    try {
+        const auto& irreg = irreg_wave_data_[key.first];
+        auto time         = std::make_shared<Eigen::VectorXd>();
+        auto values       = std::make_shared<Eigen::MatrixXd>();
+        ResampleIRF(irreg.excitation_irf_time, *irreg.excitation_irf_matrix, dt, *time, *values);
+        auto resampled = MakeResampledExcitationIRF(time, values);
+        promise.set_value(resampled);
+        return resampled;
+    } catch (...) {
+        // waiting callers get the error, later calls try again
+        promise.set_exception(std::current_exception());
+        std::lock_guard<std::mutex> lock(excitation_irf_cache_.mutex);
+        excitation_irf_cache_.entries.erase(key);
+        throw;
+    }
+}
+
+void HydroData::AddResampledExcitationIRF(int body,
+                                          double dt,
+                                          std::shared_ptr<const Eigen::VectorXd> time,
+                                          std::shared_ptr<const Eigen::MatrixXd> values) {
+    std::promise<std::shared_ptr<const ResampledExcitationIRF>> promise;
+    promise.set_value(MakeResampledExcitationIRF(std::move(time), std::move(values)));
+    std::pair<size_t, double> key(GetExcitationIRFSource(body), dt);
+    std::lock_guard<std::mutex> lock(excitation_irf_cache_.mutex);
+    excitation_irf_cache_.entries.emplace(key, promise.get_future().share());
+}
+
+int HydroData::ShareIdenticalCoefficients(double tolerance) {
+    if (tolerance < 0.0) {
+        throw std::runtime_error("Cannot share coefficients with negative tolerance: " + std::to_string(tolerance) +
+                                 ".");
+    }
+    excitation_irf_cache_.Clear();
+    CoefficientPools pools(tolerance);
+    for (size_t b = 0; b < body_data_.size(); b++) {
+        ShareBodyCoefficients(body_data_[b], irreg_wave_data_[b], pools);
+    }
+    return pools.GetNumShared();
+}
+
+Eigen::VectorXd GetTrapezoidalWidths(const Eigen::VectorXd& values) {
+    Eigen::Index n         = values.size();
+    Eigen::VectorXd widths = Eigen::VectorXd::Zero(n);
+    if (n > 1) {
+        // half the distance to each neighbour
+        Eigen::VectorXd half_steps = 0.5 * (values.tail(n - 1) - values.head(n - 1)).cwiseAbs();
+        widths.head(n - 1) += half_steps;
+        widths.tail(n - 1) += half_steps;
+    }
+    return widths;
+}
+
+void ResampleIRF(const Eigen::VectorXd& time_old,
+                 const Eigen::MatrixXd& vals_old,
+                 double dt,
+                 Eigen::VectorXd& time_new,
+                 Eigen::MatrixXd& vals_new) {
+    // 1) Resample time
+    auto t0  = time_old[0];
+    auto t1  = time_old[time_old.size() - 1];
+    time_new = Eigen::VectorXd::LinSpaced(static_cast<int>(ceil((t1 - t0) / dt)), t0, t1);
+
+    // 2) Resample values
+    assert(vals_old.rows() == 6);
+    vals_new.resize(6, time_new.size());
+
+    // We need to scale t to be [0,1] for spline use
+    Eigen::VectorXd t_old_scaled = Eigen::VectorXd::LinSpaced(time_old.size(), 0, 1);
+    Eigen::VectorXd t_new_scaled = Eigen::VectorXd::LinSpaced(time_new.size(), 0, 1);
+
+    // Use spline to get new values
+    Eigen::Spline<double, 6> spline =
+        Eigen::SplineFitting<Eigen::Spline<double, 6>>::Interpolate(vals_old, 3, t_old_scaled);
+    for (int i = 0; i < time_new.size(); i++) {
+        vals_new.col(i) = spline(t_new_scaled[i]);
+    }
+}
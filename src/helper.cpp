@@ -1,10 +1,27 @@
 #include <hydroc/helper.h>
 
+#include <algorithm>
 #include <cstdlib>
+#include <exception>
 #include <filesystem>  // C++17
 #include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
 #include <vector>
 
+#ifdef _WIN32
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
 size_t get_lower_index(double value, const std::vector<double>& ticks) {
     auto it = std::upper_bound(ticks.begin(), ticks.end(), value);
     // get nearest-below index
@@ -47,4 +64,167 @@ int hydroc::SetInitialEnvironment(int argc, char* argv[]) noexcept {
 
 std::string hydroc::getDataDir() noexcept {
     return DATADIR.lexically_normal().generic_string();
-}
\ No newline at end of file
+}
+
+#ifdef _WIN32
+hydroc::MappedFile::MappedFile(const std::string& file_name) {
+    HANDLE file = CreateFileA(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Unable to open file for mapping: " + file_name + ".");
+    }
+    file_handle_ = file;
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size)) {
+        CloseHandle(file);
+        throw std::runtime_error("Unable to get size of file: " + file_name + ".");
+    }
+    size_ = static_cast<size_t>(file_size.QuadPart);
+    if (size_ == 0) {
+        return;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        CloseHandle(file);
+        throw std::runtime_error("Unable to map file: " + file_name + ".");
+    }
+    mapping_handle_ = mapping;
+
+    data_ = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (data_ == nullptr) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        throw std::runtime_error("Unable to map view of file: " + file_name + ".");
+    }
+}
+
+hydroc::MappedFile::~MappedFile() {
+    if (data_ != nullptr) {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_handle_ != nullptr) {
+        CloseHandle(static_cast<HANDLE>(mapping_handle_));
+    }
+    if (file_handle_ != nullptr) {
+        CloseHandle(static_cast<HANDLE>(file_handle_));
+    }
+}
+#else
+hydroc::MappedFile::MappedFile(const std::string& file_name) {
+    file_descriptor_ = open(file_name.c_str(), O_RDONLY);
+    if (file_descriptor_ < 0) {
+        throw std::runtime_error("Unable to open file for mapping: " + file_name + ".");
+    }
+
+    struct stat file_stat;
+    if (fstat(file_descriptor_, &file_stat) != 0) {
+        close(file_descriptor_);
+        throw std::runtime_error("Unable to get size of file: " + file_name + ".");
+    }
+    size_ = static_cast<size_t>(file_stat.st_size);
+    if (size_ == 0) {
+        return;
+    }
+
+    void* mapped = mmap(nullptr, size_, PROT_READ, MAP_SHARED, file_descriptor_, 0);
+    if (mapped == MAP_FAILED) {
+        close(file_descriptor_);
+        throw std::runtime_error("Unable to map file: " + file_name + ".");
+    }
+    data_ = static_cast<const char*>(mapped);
+}
+
+hydroc::MappedFile::~MappedFile() {
+    if (data_ != nullptr) {
+        munmap(const_cast<char*>(data_), size_);
+    }
+    if (file_descriptor_ >= 0) {
+        close(file_descriptor_);
+    }
+}
+#endif
+
+void hydroc::ParallelFor(size_t count, int num_threads, const std::function<void(size_t, size_t)>& body) {
+    if (num_threads <= 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    size_t num_chunks = std::min(count, static_cast<size_t>(num_threads));
+    if (num_chunks <= 1) {
+        if (count > 0) {
+            body(0, count);
+        }
+        return;
+    }
+
+    // the calling thread runs the first chunk
+    std::vector<std::thread> threads;
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    auto run_chunk = [&](size_t chunk) {
+        try {
+            body(count * chunk / num_chunks, count * (chunk + 1) / num_chunks);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    };
+    for (size_t chunk = 1; chunk < num_chunks; chunk++) {
+        threads.emplace_back(run_chunk, chunk);
+    }
+    run_chunk(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void hydroc::SinCos(const Eigen::ArrayXd& x, Eigen::ArrayXd& sin_x, Eigen::ArrayXd& cos_x) {
+    // pi/2 split in three parts (fdlibm), q * pio2_1 is exact for |q| < 2^20
+    const double two_over_pi = 6.36619772367581382433e-01;
+    const double pio2_1      = 1.57079632673412561417e+00;
+    const double pio2_2      = 6.07710050630396597660e-11;
+    const double pio2_3      = 2.02226624871116645580e-21;
+    const double max_reduced = 1.0e6;
+
+    if (x.size() > 0 && x.abs().maxCoeff() > max_reduced) {
+        sin_x = x.sin();
+        cos_x = x.cos();
+        return;
+    }
+
+    // x = q pi/2 + r, |r| <= pi/4
+    Eigen::ArrayXd q = (x * two_over_pi + 0.5).floor();
+    Eigen::ArrayXd r = ((x - q * pio2_1) - q * pio2_2) - q * pio2_3;
+    Eigen::ArrayXd z = r * r;
+
+    // fdlibm kernel polynomials on [-pi/4, pi/4]
+    Eigen::ArrayXd sin_r =
+        r + r * z *
+                (-1.66666666666666324348e-01 +
+                 z * (8.33333333332248946124e-03 +
+                      z * (-1.98412698298579493134e-04 +
+                           z * (2.75573137070700676789e-06 +
+                                z * (-2.50507602534068634195e-08 + z * 1.58969099521155010221e-10)))));
+    Eigen::ArrayXd cos_r =
+        1.0 - 0.5 * z +
+        z * z *
+            (4.16666666666666019037e-02 +
+             z * (-1.38888888888741095749e-03 +
+                  z * (2.48015872894767294178e-05 +
+                       z * (-2.75573143513906633035e-07 +
+                            z * (2.08757232129817482790e-09 + z * -1.13596475577881948265e-11)))));
+
+    // quadrant q mod 4
+    Eigen::ArrayXd quadrant = q - 4.0 * (q * 0.25).floor();
+    auto odd_quadrant       = quadrant == 1.0 || quadrant == 3.0;
+    Eigen::ArrayXd sin_abs  = odd_quadrant.select(cos_r, sin_r);
+    Eigen::ArrayXd cos_abs  = odd_quadrant.select(sin_r, cos_r);
+    sin_x                   = (quadrant >= 2.0).select(-sin_abs, sin_abs);
+    cos_x                   = (quadrant == 1.0 || quadrant == 2.0).select(-cos_abs, cos_abs);
+}
@@ -0,0 +1,487 @@
+/*********************************************************************
+ * @file  hydro_data_cache.cpp
+ *
+ * @brief implementation file of HydroDataCache.
+ *********************************************************************/
+#include <hydroc/helper.h>
+#include <hydroc/hydro_data_cache.h>
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// bump whenever the layout written by WriteCacheFile changes
+const uint32_t kCacheFormatVersion = 4;
+const char kCacheMagic[8]          = {'H', 'C', 'H', 'Y', 'D', 'R', 'O', '\0'};
+
+struct CacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t num_bodies;
+    uint64_t key;
+};
+
+// FNV-1a over 8 byte words (plus trailing bytes), enough to detect a changed h5 file
+uint64_t HashBytes(const char* data, size_t size, uint64_t hash = 14695981039346656037ull) {
+    const uint64_t prime = 1099511628211ull;
+    size_t i             = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(uint64_t));
+        hash ^= word;
+        hash *= prime;
+    }
+    for (; i < size; i++) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= prime;
+    }
+    return hash;
+}
+
+template <typename T>
+uint64_t HashValue(const T& value, uint64_t hash) {
+    return HashBytes(reinterpret_cast<const char*>(&value), sizeof(T), hash);
+}
+
+// sequential binary writer for the cache file
+class CacheWriter {
+  public:
+    explicit CacheWriter(std::ofstream& out) : out_(out) {}
+
+    template <typename T>
+    void Write(const T& value) {
+        out_.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void Write(const std::string& str) {
+        Write<uint64_t>(str.size());
+        out_.write(str.data(), str.size());
+    }
+
+    void Write(const Eigen::VectorXd& vec) {
+        Write<int64_t>(vec.size());
+        WriteDoubles(vec.data(), vec.size());
+    }
+
+    void Write(const Eigen::MatrixXd& mat) {
+        Write<int64_t>(mat.rows());
+        Write<int64_t>(mat.cols());
+        WriteDoubles(mat.data(), mat.size());
+    }
+
+    void Write(const Eigen::Tensor<double, 3>& tensor) {
+        for (int i = 0; i < 3; i++) {
+            Write<int64_t>(tensor.dimension(i));
+        }
+        WriteDoubles(tensor.data(), tensor.size());
+    }
+
+  private:
+    std::ofstream& out_;
+
+    void WriteDoubles(const double* data, int64_t count) {
+        out_.write(reinterpret_cast<const char*>(data), count * sizeof(double));
+    }
+};
+
+// sequential binary reader over the memory mapped cache file, throws if the file is truncated
+class CacheReader {
+  public:
+    CacheReader(const char* data, size_t size) : data_(data), size_(size) {}
+
+    template <typename T>
+    void Read(T& value) {
+        std::memcpy(&value, Advance(sizeof(T)), sizeof(T));
+    }
+
+    void Read(std::string& str) {
+        uint64_t size;
+        Read(size);
+        str.assign(Advance(size), size);
+    }
+
+    void Read(Eigen::VectorXd& vec) {
+        int64_t size;
+        Read(size);
+        vec.resize(size);
+        ReadDoubles(vec.data(), size);
+    }
+
+    void Read(Eigen::MatrixXd& mat) {
+        int64_t rows, cols;
+        Read(rows);
+        Read(cols);
+        mat.resize(rows, cols);
+        ReadDoubles(mat.data(), rows * cols);
+    }
+
+    void Read(Eigen::Tensor<double, 3>& tensor) {
+        int64_t dims[3];
+        for (int i = 0; i < 3; i++) {
+            Read(dims[i]);
+        }
+        tensor.resize(dims[0], dims[1], dims[2]);
+        ReadDoubles(tensor.data(), tensor.size());
+    }
+
+  private:
+    const char* data_;
+    size_t size_;
+    size_t offset_ = 0;
+
+    const char* Advance(size_t num_bytes) {
+        if (num_bytes > size_ - offset_) {
+            throw std::runtime_error("Cache file is truncated.");
+        }
+        const char* current = data_ + offset_;
+        offset_ += num_bytes;
+        return current;
+    }
+
+    void ReadDoubles(double* dest, int64_t count) {
+        if (count < 0) {
+            throw std::runtime_error("Cache file is corrupted.");
+        }
+        std::memcpy(dest, Advance(count * sizeof(double)), count * sizeof(double));
+    }
+};
+
+// blocks shared between bodies are written once, bodies reference them by index
+template <typename T>
+class BlockTable {
+  public:
+    uint64_t Add(const std::shared_ptr<const T>& block) {
+        auto it = indices_.find(block.get());
+        if (it != indices_.end()) {
+            return it->second;
+        }
+        indices_[block.get()] = blocks_.size();
+        blocks_.push_back(block.get());
+        return blocks_.size() - 1;
+    }
+
+    void Write(CacheWriter& writer) const {
+        writer.Write<uint64_t>(blocks_.size());
+        for (const T* block : blocks_) {
+            writer.Write(*block);
+        }
+    }
+
+  private:
+    std::unordered_map<const T*, uint64_t> indices_;
+    std::vector<const T*> blocks_;
+};
+
+template <typename T>
+std::vector<std::shared_ptr<const T>> ReadBlocks(CacheReader& reader) {
+    uint64_t num_blocks;
+    reader.Read(num_blocks);
+    std::vector<std::shared_ptr<const T>> blocks;
+    for (uint64_t i = 0; i < num_blocks; i++) {
+        T block;
+        reader.Read(block);
+        blocks.push_back(std::make_shared<const T>(std::move(block)));
+    }
+    return blocks;
+}
+
+template <typename T>
+std::shared_ptr<const T> ReadBlockIndex(CacheReader& reader, const std::vector<std::shared_ptr<const T>>& blocks) {
+    uint64_t index;
+    reader.Read(index);
+    if (index >= blocks.size()) {
+        throw std::runtime_error("Cache file is corrupted.");
+    }
+    return blocks[index];
+}
+
+}  // namespace
+
+HydroDataCache::HydroDataCache(std::string cache_dir, bool hash_content)
+    : cache_dir_(std::move(cache_dir)), hash_content_(hash_content) {
+    std::filesystem::create_directories(cache_dir_);
+}
+
+HydroData HydroDataCache::Load(const std::string& h5_file_name,
+                               int num_bodies,
+                               const HydroDataPreprocessOptions& options) {
+    const auto& body_indices = options.selection.body_indices;
+    if (!body_indices.empty() && body_indices.size() != static_cast<size_t>(num_bodies)) {
+        throw std::runtime_error("Hydro data cache: " + std::to_string(body_indices.size()) +
+                                 " selected bodies for " + std::to_string(num_bodies) + " bodies.");
+    }
+    uint64_t key           = ComputeKey(h5_file_name, num_bodies, options);
+    std::string cache_file = GetCacheFilePath(h5_file_name, key);
+
+    if (std::filesystem::exists(cache_file)) {
+        try {
+            return ReadCacheFile(cache_file, key);
+        } catch (const std::exception& e) {
+            std::cerr << "Ignoring hydro data cache file " << cache_file << ": " << e.what() << std::endl;
+        }
+    }
+
+    // the first num_bodies bodies unless selected
+    HydroDataSelection selection = options.selection;
+    if (body_indices.empty()) {
+        for (int b = 0; b < num_bodies; b++) {
+            selection.body_indices.push_back(b);
+        }
+    }
+    HydroData data = H5FileInfo(h5_file_name, selection).ReadH5Data();
+    if (options.share_tolerance > 0.0) {
+        data.ShareIdenticalCoefficients(options.share_tolerance);
+    }
+    // after sharing, which clears the resampled IRFs
+    if (options.excitation_irf_dt > 0.0) {
+        data.ResampleExcitationIRF(options.excitation_irf_dt);
+    }
+    WriteCacheFile(data, options, cache_file, key);
+    return data;
+}
+
+std::string HydroDataCache::GetCacheFilePath(const std::string& h5_file_name,
+                                             int num_bodies,
+                                             const HydroDataPreprocessOptions& options) const {
+    return GetCacheFilePath(h5_file_name, ComputeKey(h5_file_name, num_bodies, options));
+}
+
+uint64_t HydroDataCache::ComputeKey(const std::string& h5_file_name,
+                                    int num_bodies,
+                                    const HydroDataPreprocessOptions& options) const {
+    // path, size and modification time identify the h5 file without reading it
+    std::filesystem::path h5_path = std::filesystem::weakly_canonical(h5_file_name);
+    std::string path_string       = h5_path.generic_string();
+    int64_t write_time            = std::filesystem::last_write_time(h5_path).time_since_epoch().count();
+    uint64_t key                  = HashBytes(path_string.data(), path_string.size());
+    key                           = HashValue<uint64_t>(std::filesystem::file_size(h5_path), key);
+    key                           = HashValue(write_time, key);
+    if (hash_content_) {
+        hydroc::MappedFile h5_file(h5_file_name);
+        key = HashBytes(h5_file.GetData(), h5_file.GetSize(), key);
+    }
+    key = HashValue(kCacheFormatVersion, key);
+    key = HashValue(num_bodies, key);
+    for (int body_index : options.selection.body_indices) {
+        key = HashValue(body_index, key);
+    }
+    key = HashValue(options.selection.omega_min, key);
+    key = HashValue(options.selection.omega_max, key);
+    key = HashValue(options.share_tolerance, key);
+    key = HashValue(options.excitation_irf_dt, key);
+    return key;
+}
+
+std::string HydroDataCache::GetCacheFilePath(const std::string& h5_file_name, uint64_t key) const {
+    std::ostringstream file_name;
+    file_name << std::filesystem::path(h5_file_name).stem().string() << "_" << std::hex << std::setw(16)
+              << std::setfill('0') << key << ".hcache";
+    return (std::filesystem::path(cache_dir_) / file_name.str()).generic_string();
+}
+
+HydroData HydroDataCache::ReadCacheFile(const std::string& cache_file, uint64_t key) const {
+    hydroc::MappedFile mapped(cache_file);
+    CacheReader reader(mapped.GetData(), mapped.GetSize());
+
+    CacheHeader header;
+    reader.Read(header);
+    if (std::memcmp(header.magic, kCacheMagic, sizeof(kCacheMagic)) != 0 || header.version != kCacheFormatVersion ||
+        header.key != key) {
+        throw std::runtime_error("Cache file header does not match.");
+    }
+
+    HydroData data;
+    data.resize(header.num_bodies);
+
+    auto& sim = data.sim_data_;
+    reader.Read(sim.h5_file_name);
+    reader.Read(sim.rho);
+    reader.Read(sim.g);
+    reader.Read(sim.water_depth);
+    reader.Read(sim.wave_headings);
+
+    auto matrices = ReadBlocks<Eigen::MatrixXd>(reader);
+    auto tensors  = ReadBlocks<Eigen::Tensor<double, 3>>(reader);
+
+    struct ResampledIRF {
+        uint32_t body;
+        double dt;
+        std::shared_ptr<const Eigen::VectorXd> time;
+        std::shared_ptr<const Eigen::MatrixXd> values;
+    };
+    std::vector<ResampledIRF> resampled_irfs;
+
+    for (uint32_t b = 0; b < header.num_bodies; b++) {
+        auto& body = data.body_data_[b];
+        reader.Read(body.body_name);
+        reader.Read(body.body_num);
+        reader.Read(body.disp_vol);
+        reader.Read(body.rirf_time_vector);
+        reader.Read(body.rirf_timestep);
+        reader.Read(body.cg);
+        reader.Read(body.cb);
+        body.lin_matrix = ReadBlockIndex(reader, matrices);
+        body.inf_added_mass_blocks.resize(header.num_bodies);
+        body.rirf_blocks.resize(header.num_bodies);
+        for (uint32_t c = 0; c < header.num_bodies; c++) {
+            body.inf_added_mass_blocks[c] = ReadBlockIndex(reader, matrices);
+            body.rirf_blocks[c]           = ReadBlockIndex(reader, tensors);
+        }
+        uint64_t num_radiation_blocks;
+        reader.Read(num_radiation_blocks);
+        if (num_radiation_blocks > header.num_bodies) {
+            throw std::runtime_error("Cache file is corrupted.");
+        }
+        for (uint64_t c = 0; c < num_radiation_blocks; c++) {
+            body.added_mass_blocks.push_back(ReadBlockIndex(reader, tensors));
+            body.radiation_damping_blocks.push_back(ReadBlockIndex(reader, tensors));
+        }
+
+        auto& reg = data.reg_wave_data_[b];
+        reader.Read(reg.freq_list);
+        reader.Read(reg.excitation_mag_matrix);
+        reader.Read(reg.excitation_phase_matrix);
+
+        auto& irreg = data.irreg_wave_data_[b];
+        reader.Read(irreg.excitation_irf_time);
+        irreg.excitation_irf_matrix = ReadBlockIndex(reader, matrices);
+        uint8_t has_resampled;
+        reader.Read(has_resampled);
+        if (has_resampled) {
+            double dt;
+            auto time = std::make_shared<Eigen::VectorXd>();
+            reader.Read(dt);
+            reader.Read(*time);
+            resampled_irfs.push_back({b, dt, time, ReadBlockIndex(reader, matrices)});
+        }
+    }
+    // the resampled IRFs go into the cache of the data once every body has its IRF, which identifies the bodies
+    // sharing one resampled IRF
+    for (auto& irf : resampled_irfs) {
+        data.AddResampledExcitationIRF(irf.body, irf.dt, irf.time, irf.values);
+    }
+    if (header.num_bodies > 0) {
+        data.frequency_table_ = FrequencyTable(data.reg_wave_data_[0].freq_list);
+    }
+
+    return data;
+}
+
+void HydroDataCache::WriteCacheFile(const HydroData& data,
+                                    const HydroDataPreprocessOptions& options,
+                                    const std::string& cache_file,
+                                    uint64_t key) const {
+    // write to a unique temporary file first, other processes may be reading or writing the same cache file
+    std::ostringstream tmp_suffix;
+    tmp_suffix << ".tmp" << std::hash<std::thread::id>{}(std::this_thread::get_id())
+               << std::chrono::steady_clock::now().time_since_epoch().count();
+    std::string tmp_file = cache_file + tmp_suffix.str();
+
+    std::ofstream out(tmp_file, std::ios::binary);
+    if (!out) {
+        std::cerr << "Unable to write hydro data cache file: " << tmp_file << std::endl;
+        return;
+    }
+    CacheWriter writer(out);
+
+    CacheHeader header;
+    std::memcpy(header.magic, kCacheMagic, sizeof(kCacheMagic));
+    header.version    = kCacheFormatVersion;
+    header.num_bodies = static_cast<uint32_t>(data.body_data_.size());
+    header.key        = key;
+    writer.Write(header);
+
+    const auto& sim = data.sim_data_;
+    writer.Write(sim.h5_file_name);
+    writer.Write(sim.rho);
+    writer.Write(sim.g);
+    writer.Write(sim.water_depth);
+    writer.Write(sim.wave_headings);
+
+    // coefficient blocks shared between bodies are only written once
+    BlockTable<Eigen::MatrixXd> matrices;
+    BlockTable<Eigen::Tensor<double, 3>> tensors;
+    std::vector<std::shared_ptr<const HydroData::ResampledExcitationIRF>> resampled_irfs(header.num_bodies);
+    for (uint32_t b = 0; b < header.num_bodies; b++) {
+        const auto& body  = data.body_data_[b];
+        const auto& irreg = data.irreg_wave_data_[b];
+        matrices.Add(body.lin_matrix);
+        for (uint32_t c = 0; c < header.num_bodies; c++) {
+            matrices.Add(body.inf_added_mass_blocks[c]);
+            tensors.Add(body.rirf_blocks[c]);
+        }
+        for (size_t c = 0; c < body.added_mass_blocks.size(); c++) {
+            tensors.Add(body.added_mass_blocks[c]);
+            tensors.Add(body.radiation_damping_blocks[c]);
+        }
+        matrices.Add(irreg.excitation_irf_matrix);
+        if (options.excitation_irf_dt > 0.0) {
+            resampled_irfs[b] = data.GetResampledExcitationIRF(b, options.excitation_irf_dt);
+            matrices.Add(resampled_irfs[b]->values);
+        }
+    }
+    matrices.Write(writer);
+    tensors.Write(writer);
+
+    for (uint32_t b = 0; b < header.num_bodies; b++) {
+        const auto& body = data.body_data_[b];
+        writer.Write(body.body_name);
+        writer.Write(body.body_num);
+        writer.Write(body.disp_vol);
+        writer.Write(body.rirf_time_vector);
+        writer.Write(body.rirf_timestep);
+        writer.Write(body.cg);
+        writer.Write(body.cb);
+        writer.Write(matrices.Add(body.lin_matrix));
+        for (uint32_t c = 0; c < header.num_bodies; c++) {
+            writer.Write(matrices.Add(body.inf_added_mass_blocks[c]));
+            writer.Write(tensors.Add(body.rirf_blocks[c]));
+        }
+        writer.Write<uint64_t>(body.added_mass_blocks.size());
+        for (size_t c = 0; c < body.added_mass_blocks.size(); c++) {
+            writer.Write(tensors.Add(body.added_mass_blocks[c]));
+            writer.Write(tensors.Add(body.radiation_damping_blocks[c]));
+        }
+
+        const auto& reg = data.reg_wave_data_[b];
+        writer.Write(reg.freq_list);
+        writer.Write(reg.excitation_mag_matrix);
+        writer.Write(reg.excitation_phase_matrix);
+
+        const auto& irreg = data.irreg_wave_data_[b];
+        writer.Write(irreg.excitation_irf_time);
+        writer.Write(matrices.Add(irreg.excitation_irf_matrix));
+        uint8_t has_resampled = resampled_irfs[b] != nullptr;
+        writer.Write(has_resampled);
+        if (has_resampled) {
+            writer.Write(options.excitation_irf_dt);
+            writer.Write(*resampled_irfs[b]->time);
+            writer.Write(matrices.Add(resampled_irfs[b]->values));
+        }
+    }
+
+    out.close();
+    if (!out) {
+        std::cerr << "Unable to write hydro data cache file: " << tmp_file << std::endl;
+        std::filesystem::remove(tmp_file);
+        return;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tmp_file, cache_file, error);
+    if (error) {
+        std::filesystem::remove(tmp_file, error);
+    }
+}
@@ -163,13 +163,25 @@ void ForceFunc6d::ApplyForceAndTorqueToBody() {
 TestHydro::TestHydro(std::vector<std::shared_ptr<ChBody>> user_bodies,
                      std::string h5_file_name,
                      std::shared_ptr<WaveBase> waves)
-    : bodies_(user_bodies),
-      num_bodies_(bodies_.size()),
-      file_info_(H5FileInfo(h5_file_name, num_bodies_).ReadH5Data()) {
+    : TestHydro(user_bodies, H5FileInfo(h5_file_name, user_bodies.size()).ReadH5Data(), waves) {}
+
+TestHydro::TestHydro(std::vector<std::shared_ptr<ChBody>> user_bodies,
+                     HydroData hydro_data,
+                     std::shared_ptr<WaveBase> waves)
+    : TestHydro(user_bodies, std::make_shared<const HydroData>(std::move(hydro_data)), waves) {}
+
+TestHydro::TestHydro(std::vector<std::shared_ptr<ChBody>> user_bodies,
+                     std::shared_ptr<const HydroData> hydro_data,
+                     std::shared_ptr<WaveBase> waves)
+    : bodies_(user_bodies), num_bodies_(bodies_.size()), file_info_(std::move(hydro_data)) {
+    if (file_info_ == nullptr || file_info_->GetNumBodies() < num_bodies_) {
+        throw std::runtime_error("Hydro data does not contain data for all " + std::to_string(num_bodies_) +
+                                 " bodies in TestHydro.");
+    }
     prev_time = -1;
 
     // Set up time vector
-    rirf_time_vector = file_info_.GetRIRFTimeVector();
+    rirf_time_vector = file_info_->GetRIRFTimeVector();
     // width array
     rirf_width_vector.resize(rirf_time_vector.size());
     for (int ii = 0; ii < rirf_width_vector.size(); ii++) {
@@ -203,8 +215,8 @@ TestHydro::TestHydro(std::vector<std::shared_ptr<ChBody>> user_bodies,
             unsigned eq_idx = i + kDofPerBody * b;
             unsigned c_idx  = i + kDofLinOrRot * b;
 
-            equilibrium_[eq_idx] = file_info_.GetCGVector(b)[i];
-            cb_minus_cg_[c_idx]  = file_info_.GetCBVector(b)[i] - file_info_.GetCGVector(b)[i];
+            equilibrium_[eq_idx] = file_info_->GetCGVector(b)[i];
+            cb_minus_cg_[c_idx]  = file_info_->GetCBVector(b)[i] - file_info_->GetCGVector(b)[i];
         }
     }
 
@@ -221,7 +233,7 @@ TestHydro::TestHydro(std::vector<std::shared_ptr<ChBody>> user_bodies,
     }
 
     my_loadbodyinertia =
-        chrono_types::make_shared<ChLoadAddedMass>(file_info_.GetBodyInfos(), loadables, bodies_[0]->GetSystem());
+        chrono_types::make_shared<ChLoadAddedMass>(file_info_, loadables, bodies_[0]->GetSystem());
 
     bodies_[0]->GetSystem()->Add(my_loadcontainer);
     my_loadcontainer->Add(my_loadbodyinertia);
@@ -237,12 +249,17 @@ void TestHydro::AddWaves(std::shared_ptr<WaveBase> waves) {
     switch (user_waves_->GetWaveMode()) {
         case WaveMode::regular: {
             auto reg = std::static_pointer_cast<RegularWave>(user_waves_);
-            reg->AddH5Data(file_info_.GetRegularWaveInfos(), file_info_.GetSimulationInfo());
+            reg->AddH5Data(file_info_);
             break;
         }
         case WaveMode::irregular: {
             auto irreg = std::static_pointer_cast<IrregularWaves>(user_waves_);
-            irreg->AddH5Data(file_info_.GetIrregularWaveInfos(), file_info_.GetSimulationInfo());
+            irreg->AddH5Data(file_info_);
+            break;
+        }
+        case WaveMode::polychromatic: {
+            auto poly = std::static_pointer_cast<PolychromaticWave>(user_waves_);
+            poly->AddH5Data(file_info_);
             break;
         }
     }
@@ -253,7 +270,7 @@ void TestHydro::AddWaves(std::shared_ptr<WaveBase> waves) {
 std::vector<double> TestHydro::ComputeForceHydrostatics() {
     assert(num_bodies_ > 0);
 
-    const double rho = file_info_.GetRhoVal();
+    const double rho = file_info_->GetRhoVal();
     const auto g_acc = bodies_[0]->GetSystem()->Get_G_acc();  // assuming all bodies in same system
     const double gg  = g_acc.Length();
 
@@ -274,13 +291,13 @@ std::vector<double> TestHydro::ComputeForceHydrostatics() {
             body_displacement[ii + kDofLinOrRot] = body_rotation[ii] - body_equilibrium[ii + kDofLinOrRot];
         }
 
-        const auto force_offset = -gg * rho * file_info_.GetLinMatrix(b) * body_displacement;
+        const auto force_offset = -gg * rho * file_info_->GetLinMatrix(b) * body_displacement;
         for (int dof = 0; dof < kDofPerBody; dof++) {
             body_force_hydrostatic[dof] += force_offset[dof];
         }
 
         // buoyancy at equilibrium
-        const auto buoyancy = rho * (-g_acc) * file_info_.GetDispVolVal(b);
+        const auto buoyancy = rho * (-g_acc) * file_info_->GetDispVolVal(b);
 
         for (int ii = 0; ii < kDofLinOrRot; ii++) {
             body_force_hydrostatic[ii] += buoyancy[ii];
@@ -300,7 +317,7 @@ std::vector<double> TestHydro::ComputeForceHydrostatics() {
 }
 
 std::vector<double> TestHydro::ComputeForceRadiationDampingConv() {
-    const int size    = file_info_.GetRIRFDims(2);
+    const int size    = file_info_->GetRIRFDims(2);
     const int numRows = kDofPerBody * num_bodies_;
     const int numCols = kDofPerBody * num_bodies_;
 
@@ -395,7 +412,7 @@ std::vector<double> TestHydro::ComputeForceRadiationDampingConv() {
 
 double TestHydro::GetRIRFval(int row, int col, int st) {
     if (row < 0 || row >= kDofPerBody * num_bodies_ || col < 0 || col >= kDofPerBody * num_bodies_ || st < 0 ||
-        st >= file_info_.GetRIRFDims(2)) {
+        st >= file_info_->GetRIRFDims(2)) {
         throw std::out_of_range("rirfval index out of range in TestHydro");
     }
 
@@ -403,7 +420,7 @@ double TestHydro::GetRIRFval(int row, int col, int st) {
     int col_dof    = col % kDofPerBody;
     int row_dof    = row % kDofPerBody;
 
-    return file_info_.GetRIRFVal(body_index, row_dof, col, st);
+    return file_info_->GetRIRFVal(body_index, row_dof, col, st);
 }
 
 Eigen::VectorXd TestHydro::ComputeForceWaves() {
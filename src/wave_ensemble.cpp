@@ -0,0 +1,70 @@
+/*********************************************************************
+ * @file  wave_ensemble.cpp
+ *
+ * @brief implementation file of IrregularWaveEnsemble.
+ *********************************************************************/
+#include <hydroc/helper.h>
+#include <hydroc/wave_ensemble.h>
+
+#include <stdexcept>
+#include <utility>
+
+IrregularWaveEnsemble::IrregularWaveEnsemble(const IrregularWaveParams& params,
+                                             std::shared_ptr<const HydroData> hydro_data)
+    : params_(params) {
+    if (!params_.eta_file_path_.empty() || params_.wave_height_ == 0.0 || params_.wave_period_ == 0.0) {
+        throw std::runtime_error(
+            "Irregular wave ensemble: needs a wave spectrum (wave height and period, no eta file).");
+    }
+    if (params_.simulation_dt_ <= 0.0) {
+        throw std::runtime_error("Irregular wave ensemble: simulation_dt_ has to be positive.");
+    }
+
+    sea_state_ = std::make_shared<IrregularWaves>(params_);
+    sea_state_->SetUpSeaState(std::move(hydro_data));
+
+    // the realizations run in parallel, each on one thread, and share the diagnostics sink otherwise
+    sea_state_->params_.num_threads_ = 1;
+    sea_state_->params_.diagnostics_ = nullptr;
+}
+
+std::vector<IrregularWaveRealization> IrregularWaveEnsemble::Generate(const std::vector<int>& seeds,
+                                                                      bool compute_excitation) const {
+    if (compute_excitation && params_.streaming_free_surface_) {
+        throw std::runtime_error(
+            "Irregular wave ensemble: the excitation force cannot be precomputed from a streamed free surface "
+            "elevation, generate the realizations without it.");
+    }
+
+    Eigen::VectorXd times = GetExcitationTimes();
+    std::vector<IrregularWaveRealization> realizations(seeds.size());
+    hydroc::ParallelFor(seeds.size(), params_.num_threads_, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            auto& realization = realizations[i];
+            realization.seed  = seeds[i];
+            realization.waves = sea_state_->CreateRealization(seeds[i]);
+            if (compute_excitation) {
+                // FFT convolution over the whole series instead of one convolution per time step, on a copy so the
+                // realization keeps the excitation of its parameters (synthesized force of frequency domain
+                // excitation)
+                IrregularWaves force_waves = *realization.waves;
+                if (!force_waves.frequency_domain_force_ && force_waves.force_series_.empty()) {
+                    force_waves.params_.precompute_excitation_force_ = true;
+                    force_waves.PrecomputeExcitationForce();
+                }
+                realization.excitation_force.resize(6 * params_.num_bodies_, times.size());
+                for (Eigen::Index n = 0; n < times.size(); n++) {
+                    realization.excitation_force.col(n) = force_waves.GetForceAtTime(times[n]);
+                }
+            }
+            // later precomputations of the realization (streaming) use the threads of the parameters
+            realization.waves->params_.num_threads_ = params_.num_threads_;
+        }
+    });
+    return realizations;
+}
+
+Eigen::VectorXd IrregularWaveEnsemble::GetExcitationTimes() const {
+    int num_timesteps = static_cast<int>(params_.simulation_duration_ / params_.simulation_dt_) + 1;
+    return Eigen::VectorXd::LinSpaced(num_timesteps, 0.0, (num_timesteps - 1) * params_.simulation_dt_);
+}
@@ -3,184 +3,154 @@
  *
  * @brief implementation file for Wavebase and classes inheriting from WaveBase.
  *********************************************************************/
+#include <H5Cpp.h>
+#include <hydroc/dispersion.h>
 #include <hydroc/helper.h>
 #include <hydroc/wave_types.h>
+#include <unsupported/Eigen/FFT>
 #include <unsupported/Eigen/Splines>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+
+// sum_i Re(amplitudes_i exp(2 pi i f_i t)) at t0 + n dt for uniformly spaced frequencies f_i, with FFTs
+std::vector<double> GetEtaTimeSeriesChirpZ(double t0,
+                                           double dt,
+                                           int num_times,
+                                           const Eigen::VectorXd& freqs_hz,
+                                           const Eigen::VectorXcd& amplitudes) {
+    typedef std::complex<double> Complex;
+    int num_freqs = freqs_hz.size();
+    std::vector<double> eta(std::max(num_times, 0), 0.0);
+    if (num_freqs == 0 || num_times <= 0) {
+        return eta;
+    }
+    double df = num_freqs > 1 ? (freqs_hz[num_freqs - 1] - freqs_hz[0]) / (num_freqs - 1) : 0.0;
+    for (int i = 1; i < num_freqs - 1; i++) {
+        if (std::abs(freqs_hz[i] - (freqs_hz[0] + i * df)) > 1e-9 * std::max(df, std::abs(freqs_hz[i]))) {
+            throw std::runtime_error("FFT free surface elevation needs uniformly spaced frequencies.");
+        }
+    }
 
-double GetEta(const Eigen::Vector3d& position,
-              double time,
-              double omega,
-              double amplitude,
-              double phase,
-              double wavenumber) {
-    // assuming wave direction along global X axis
-    auto x_pos = position.x();
+    // eta(t0 + n dt) = Re(exp(2 pi i f_0 t_n) sum_i d_i z^(i n)), with z = exp(2 pi i df dt) and
+    // d_i = amplitudes_i exp(2 pi i i df t0).
+    // Bluestein: z^(i n) = z^(n^2/2) z^(i^2/2) z^(-(n-i)^2/2), so the sum is a convolution.
+    // The chirp phase grows with k^2, so it is reduced to [0, 1) cycles with the rounding error of the product kept.
+    const double half_cycles = 0.5 * df * dt;
+
+    auto chirp = [half_cycles](int64_t k) {
+        double k2     = static_cast<double>(k) * static_cast<double>(k);
+        double cycles = half_cycles * k2;
+        double error  = std::fma(half_cycles, k2, -cycles);
+        return std::polar(1.0, 2 * M_PI * ((cycles - std::floor(cycles)) + error));
+    };
+
+    size_t fft_size = 1;
+    while (fft_size < static_cast<size_t>(num_freqs + num_times - 1)) {
+        fft_size *= 2;
+    }
+    std::vector<Complex> components(fft_size, 0.0);
+    std::vector<Complex> kernel(fft_size, 0.0);
+    for (int i = 0; i < num_freqs; i++) {
+        double cycles = i * df * t0;
+        components[i] = amplitudes[i] * std::polar(1.0, 2 * M_PI * (cycles - std::floor(cycles))) * chirp(i);
+    }
+    for (int64_t m = -(num_freqs - 1); m < num_times; m++) {
+        kernel[(m + fft_size) % fft_size] = std::conj(chirp(m));
+    }
 
-    auto eta = amplitude * cos(wavenumber * x_pos - omega * time + phase);
-    return eta;
-};
+    Eigen::FFT<double> fft;
+    std::vector<Complex> components_hat, kernel_hat, convolution;
+    fft.fwd(components_hat, components);
+    fft.fwd(kernel_hat, kernel);
+    for (size_t j = 0; j < fft_size; j++) {
+        components_hat[j] *= kernel_hat[j];
+    }
+    fft.inv(convolution, components_hat);
 
-double GetEtaIrregular(const Eigen::Vector3d& position,
-                       double time,
-                       const Eigen::VectorXd& freqs_hz,
-                       const Eigen::VectorXd& spectral_densities,
-                       const Eigen::VectorXd& spectral_widths,
-                       const Eigen::VectorXd& wave_phases,
-                       const Eigen::VectorXd& wavenumbers) {
-    // x position assuming wave direction along global X axis
-    double x_pos = position.x();
-
-    double eta = 0.0;
-    for (size_t i = 0; i < freqs_hz.size(); ++i) {
-        auto amplitude = std::sqrt(2 * spectral_densities[i] * spectral_widths[i]);
-        auto omega     = 2 * M_PI * freqs_hz[i];
-        eta += GetEta(position, time, omega, amplitude, wave_phases[i], wavenumbers[i]);
+    for (int n = 0; n < num_times; n++) {
+        Complex carrier = std::polar(1.0, 2 * M_PI * freqs_hz[0] * (t0 + n * dt));
+        eta[n]          = (carrier * chirp(n) * convolution[n]).real();
     }
     return eta;
 }
 
-std::vector<double> GetEtaIrregularTimeSeries(const Eigen::Vector3d& position,
-                                              const std::vector<double> time_index,
-                                              const Eigen::VectorXd& freqs_hz,
-                                              const Eigen::VectorXd& spectral_densities,
-                                              const Eigen::VectorXd& spectral_widths,
-                                              const Eigen::VectorXd& wave_phases,
-                                              const Eigen::VectorXd& wavenumbers) {
-    std::vector<double> eta(time_index.size(), 0.0);
-    for (size_t j = 0; j < time_index.size(); ++j) {
-        eta[j] = GetEtaIrregular(position, time_index[j], freqs_hz, spectral_densities, spectral_widths, wave_phases,
-                                 wavenumbers);
+std::vector<double> GetEtaIrregularTimeSeriesFFT(const Eigen::Vector3d& position,
+                                                 double t0,
+                                                 double dt,
+                                                 int num_times,
+                                                 const Eigen::VectorXd& freqs_hz,
+                                                 const Eigen::VectorXd& spectral_densities,
+                                                 const Eigen::VectorXd& spectral_widths,
+                                                 const Eigen::VectorXd& wave_phases,
+                                                 const Eigen::VectorXd& wavenumbers) {
+    // a_i cos(k_i x - omega_i t + phi_i) = Re(a_i exp(-i (k_i x + phi_i)) exp(i omega_i t))
+    Eigen::VectorXcd amplitudes(freqs_hz.size());
+    for (int i = 0; i < freqs_hz.size(); i++) {
+        double amplitude = std::sqrt(2 * spectral_densities[i] * spectral_widths[i]);
+        amplitudes[i]    = std::polar(amplitude, -(wavenumbers[i] * position.x() + wave_phases[i]));
     }
-    return eta;
+    return GetEtaTimeSeriesChirpZ(t0, dt, num_times, freqs_hz, amplitudes);
 }
 
-Eigen::Vector3d GetWaterVelocity(const Eigen::Vector3d& position,
-                                 double time,
-                                 double omega,
-                                 double amplitude,
-                                 double phase,
-                                 double wavenumber,
-                                 double water_depth,
-                                 double mwl) {
-    // assuming wave along global X axis position
-    auto x_pos = position.x();
-    // position relative to mean water level
-    auto z_pos = position.z() - mwl;
+void WaveBase::GetElevations(const Eigen::MatrixX3d& positions, double time, Eigen::VectorXd& elevations) {
+    elevations.resize(positions.rows());
+    for (Eigen::Index p = 0; p < positions.rows(); p++) {
+        elevations[p] = GetElevation(positions.row(p).transpose(), time);
+    }
+}
 
-    // get water velocity
-    auto water_velocity = Eigen::Vector3d(0.0, 0.0, 0.0);
-    if (2 * M_PI / wavenumber > water_depth || wavenumber * water_depth > 500.0) {
-        // deep water
-        water_velocity[0] =
-            omega * amplitude * std::exp(wavenumber * z_pos) * cos(wavenumber * x_pos - omega * time + phase);
-        water_velocity[2] =
-            omega * amplitude * std::exp(wavenumber * z_pos) * sin(wavenumber * x_pos - omega * time + phase);
-    } else {
-        // shallow water
-        water_velocity[0] = omega * amplitude * std::cosh(wavenumber * (z_pos + water_depth)) /
-                            std::sinh(wavenumber * water_depth) * cos(wavenumber * x_pos - omega * time + phase);
-        water_velocity[2] = omega * amplitude * std::sinh(wavenumber * (z_pos + water_depth)) /
-                            std::sinh(wavenumber * water_depth) * sin(wavenumber * x_pos - omega * time + phase);
+void WaveBase::GetVelocities(const Eigen::MatrixX3d& positions, double time, Eigen::MatrixX3d& velocities) {
+    velocities.resize(positions.rows(), 3);
+    for (Eigen::Index p = 0; p < positions.rows(); p++) {
+        velocities.row(p) = GetVelocity(positions.row(p).transpose(), time).transpose();
     }
+}
 
-    return water_velocity;
+void WaveBase::GetAccelerations(const Eigen::MatrixX3d& positions, double time, Eigen::MatrixX3d& accelerations) {
+    accelerations.resize(positions.rows(), 3);
+    for (Eigen::Index p = 0; p < positions.rows(); p++) {
+        accelerations.row(p) = GetAcceleration(positions.row(p).transpose(), time).transpose();
+    }
 }
 
-Eigen::Vector3d GetWaterAcceleration(const Eigen::Vector3d& position,
-                                     double time,
-                                     double omega,
-                                     double amplitude,
-                                     double phase,
-                                     double wavenumber,
-                                     double water_depth,
-                                     double mwl) {
-    // assuming wave along global X axis position
-    auto x_pos = position.x();
-    // position relative to mean water level
-    auto z_pos = position.z() - mwl;
+WaveKinematics WaveBase::GetKinematics(const Eigen::Vector3d& position, double time) {
+    WaveKinematics kinematics;
+    kinematics.elevation    = GetElevation(position, time);
+    kinematics.velocity     = GetVelocity(position, time);
+    kinematics.acceleration = GetAcceleration(position, time);
+    return kinematics;
+}
 
-    // get water velocity
-    auto water_acceleration = Eigen::Vector3d(0.0, 0.0, 0.0);
+// horizontal and vertical decay with depth of the kinematics of one wave component at several depths z below the
+// mean water level, deep water if 2 pi / k > d or k d > 500
+void GetDepthFactors(double wavenumber,
+                     double water_depth,
+                     const Eigen::ArrayXd& z,
+                     Eigen::ArrayXd& horizontal,
+                     Eigen::ArrayXd& vertical) {
     if (2 * M_PI / wavenumber > water_depth || wavenumber * water_depth > 500.0) {
-        // deep water
-        water_acceleration[0] =
-            omega * omega * amplitude * std::exp(wavenumber * z_pos) * sin(wavenumber * x_pos - omega * time + phase);
-        water_acceleration[2] =
-            -omega * omega * amplitude * std::exp(wavenumber * z_pos) * cos(wavenumber * x_pos - omega * time + phase);
+        horizontal = (wavenumber * z).exp();
+        vertical   = horizontal;
     } else {
-        // shallow water
-        water_acceleration[0] = omega * omega * amplitude * std::cosh(wavenumber * (z_pos + water_depth)) /
-                                std::sinh(wavenumber * water_depth) * sin(wavenumber * x_pos - omega * time + phase);
-        water_acceleration[2] = -omega * omega * amplitude * std::sinh(wavenumber * (z_pos + water_depth)) /
-                                std::sinh(wavenumber * water_depth) * cos(wavenumber * x_pos - omega * time + phase);
-    }
-    return water_acceleration;
-}
-
-Eigen::Vector3d GetWaterVelocityIrregular(const Eigen::Vector3d& position,
-                                          double time,
-                                          const Eigen::VectorXd& freqs_hz,
-                                          const Eigen::VectorXd& spectral_densities,
-                                          const Eigen::VectorXd& spectral_widths,
-                                          const Eigen::VectorXd& wave_phases,
-                                          const Eigen::VectorXd& wavenumbers,
-                                          double water_depth,
-                                          double mwl) {
-    auto water_velocity = Eigen::Vector3d(0.0, 0.0, 0.0);
-    for (size_t i = 0; i < freqs_hz.size(); ++i) {
-        auto amplitude = std::sqrt(2 * spectral_densities[i] * spectral_widths[i]);
-        auto omega     = 2 * M_PI * freqs_hz[i];
-        water_velocity +=
-            GetWaterVelocity(position, time, omega, amplitude, wave_phases[i], wavenumbers[i], water_depth, mwl);
-    }
-    return water_velocity;
-}
-
-Eigen::Vector3d GetWaterAccelerationIrregular(const Eigen::Vector3d& position,
-                                              double time,
-                                              const Eigen::VectorXd& freqs_hz,
-                                              const Eigen::VectorXd& spectral_densities,
-                                              const Eigen::VectorXd& spectral_widths,
-                                              const Eigen::VectorXd& wave_phases,
-                                              const Eigen::VectorXd& wavenumbers,
-                                              double water_depth,
-                                              double mwl) {
-    auto water_acceleration = Eigen::Vector3d(0.0, 0.0, 0.0);
-    for (size_t i = 0; i < freqs_hz.size(); ++i) {
-        auto amplitude = std::sqrt(2 * spectral_densities[i] * spectral_widths[i]);
-        auto omega     = 2 * M_PI * freqs_hz[i];
-        water_acceleration +=
-            GetWaterAcceleration(position, time, omega, amplitude, wave_phases[i], wavenumbers[i], water_depth, mwl);
-    }
-    return water_acceleration;
-}
-
-double ComputeWaveNumber(double omega,
-                         double water_depth,
-                         double g,
-                         double tolerance   = 1e-6,
-                         int max_iterations = 100) {
-    if (water_depth <= 0.0) {
-        throw std::runtime_error("Cannot compute wavenumber with water depth: " + std::to_string(water_depth) + ".");
-    }
-
-    // Initial guess for wave number (using deep water approximation)
-    double k = omega * omega / g;
-
-    int iterations = 0;
-    double error   = 1.0;
-    while (error > tolerance && iterations < max_iterations) {
-        double tanh_kh = std::tanh(k * water_depth);
-        double f       = omega * omega - g * k * tanh_kh;
-        double df      = -2.0 * g * tanh_kh - g * k * water_depth * (1.0 - tanh_kh * tanh_kh);
-
-        double delta_k = f / df;
-        k -= delta_k;
-        error = std::abs(delta_k);
-        iterations++;
-    }
-
-    return k;
+        double sinh_kd = std::sinh(wavenumber * water_depth);
+        horizontal     = (wavenumber * (z + water_depth)).cosh() / sinh_kd;
+        vertical       = (wavenumber * (z + water_depth)).sinh() / sinh_kd;
+    }
+}
+
+// phase k (x cos(heading) + y sin(heading)) - omega t + phase of one wave component travelling along a heading at
+// several positions
+Eigen::ArrayXd GetComponentArguments(const Eigen::MatrixX3d& positions,
+                                     double wavenumber,
+                                     double cos_heading,
+                                     double sin_heading,
+                                     double omega,
+                                     double time,
+                                     double phase) {
+    return wavenumber * (cos_heading * positions.col(0).array() + sin_heading * positions.col(1).array()) -
+           omega * time + phase;
 }
 
 Eigen::VectorXd NoWave::GetForceAtTime(double t) {
@@ -192,6 +162,82 @@ Eigen::VectorXd NoWave::GetForceAtTime(double t) {
     return f;
 }
 
+HeadingInterp GetHeadingInterp(const Eigen::VectorXd& headings, double heading) {
+    int num_headings   = headings.size();
+    double min_heading = headings.minCoeff();
+    double max_heading = headings.maxCoeff();
+    const double tol   = 1e-9;
+
+    // wrap into [min_heading, min_heading + 360)
+    double wrapped = heading;
+    while (wrapped < min_heading - tol) {
+        wrapped += 360.0;
+    }
+    while (wrapped >= min_heading + 360.0 - tol) {
+        wrapped -= 360.0;
+    }
+
+    HeadingInterp interp{0, 0, 0.0};
+    double max_step = 0.0;
+    for (int i = 0; i < num_headings; i++) {
+        interp.index       = i;
+        interp.upper_index = i;
+        if (std::abs(headings[i] - wrapped) <= tol) {
+            return interp;
+        }
+        if (i + 1 < num_headings) {
+            max_step = std::max(max_step, headings[i + 1] - headings[i]);
+            if (headings[i] < wrapped && wrapped < headings[i + 1]) {
+                interp.upper_index = i + 1;
+                interp.weight      = (wrapped - headings[i]) / (headings[i + 1] - headings[i]);
+                return interp;
+            }
+        }
+    }
+
+    // headings around the whole circle (no gap larger than their step): across the seam from the last heading to
+    // the first heading + 360
+    double seam_step = headings[0] + 360.0 - headings[num_headings - 1];
+    if (num_headings > 1 && seam_step <= max_step + tol && wrapped > headings[num_headings - 1]) {
+        interp.index       = num_headings - 1;
+        interp.upper_index = 0;
+        interp.weight      = (wrapped - headings[num_headings - 1]) / seam_step;
+        return interp;
+    }
+    throw std::runtime_error("Wave heading " + std::to_string(heading) + " is outside of the wave headings [" +
+                             std::to_string(min_heading) + ", " + std::to_string(max_heading) +
+                             "] of the h5 file.");
+}
+
+void InterpolateExcitation(const HydroData::RegularWaveInfo& reg,
+                           int dof,
+                           const HeadingInterp& heading,
+                           const FrequencyTable::Interp& freq,
+                           double& magnitude,
+                           double& phase) {
+    // phases are blended along the shortest arc, so phases on both sides of +/- pi do not average to 0
+    auto blend = [](double value, double upper, double weight, bool is_phase) {
+        double step = is_phase ? std::remainder(upper - value, 2 * M_PI) : upper - value;
+        return value + weight * step;
+    };
+    auto interp_freq = [&](const Eigen::Tensor<double, 3>& matrix, int heading_index, bool is_phase) {
+        double value = matrix(dof, heading_index, freq.index);
+        if (freq.weight > 0.0) {
+            value = blend(value, matrix(dof, heading_index, freq.index + 1), freq.weight, is_phase);
+        }
+        return value;
+    };
+    auto interp = [&](const Eigen::Tensor<double, 3>& matrix, bool is_phase) {
+        double value = interp_freq(matrix, heading.index, is_phase);
+        if (heading.weight > 0.0) {
+            value = blend(value, interp_freq(matrix, heading.upper_index, is_phase), heading.weight, is_phase);
+        }
+        return value;
+    };
+    magnitude = interp(reg.excitation_mag_matrix, false);
+    phase     = interp(reg.excitation_phase_matrix, true);
+}
+
 RegularWave::RegularWave() {
     num_bodies_ = 1;
 }
@@ -201,14 +247,30 @@ RegularWave::RegularWave(unsigned int num_b) {
 }
 
 void RegularWave::Initialize() {
-    wavenumber_ = ComputeWaveNumber(regular_wave_omega_, water_depth_, g_);
+    wavenumber_ = DispersionSolver::Get(water_depth_, g_)->GetWaveNumber(regular_wave_omega_);
+    // the kinematics travel along the heading
+    heading_cos_ = std::cos(regular_wave_heading_ * M_PI / 180.0);
+    heading_sin_ = std::sin(regular_wave_heading_ * M_PI / 180.0);
+
+    int total_dofs = 6 * num_bodies_;
+    excitation_coef_re_.resize(total_dofs);
+    excitation_coef_im_.resize(total_dofs);
+    for (int i = 0; i < total_dofs; i++) {
+        excitation_coef_re_[i] = excitation_force_mag_[i] * cos(excitation_force_phase_[i]);
+        excitation_coef_im_[i] = excitation_force_mag_[i] * sin(excitation_force_phase_[i]);
+    }
+    force_.setZero(total_dofs);
+
+    // forget the phasor of a previous run
+    phasor_time_        = std::numeric_limits<double>::quiet_NaN();
+    phasor_dt_          = std::numeric_limits<double>::quiet_NaN();
+    steps_since_anchor_ = 0;
 }
 
-void RegularWave::AddH5Data(std::vector<HydroData::RegularWaveInfo>& reg_h5_data,
-                            HydroData::SimulationParameters& sim_data) {
-    wave_info_   = reg_h5_data;
-    water_depth_ = sim_data.water_depth;
-    g_           = sim_data.g;
+void RegularWave::AddH5Data(std::shared_ptr<const HydroData> hydro_data) {
+    hydro_data_  = std::move(hydro_data);
+    water_depth_ = hydro_data_->GetSimulationInfo().water_depth;
+    g_           = hydro_data_->GetSimulationInfo().g;
 
     // set up regular waves here, call other helper functions as necessary
     int total_dofs = 6 * num_bodies_;
@@ -216,81 +278,236 @@ void RegularWave::AddH5Data(std::vector<HydroData::RegularWaveInfo>& reg_h5_data
     excitation_force_phase_.resize(total_dofs);
     force_.resize(total_dofs);
 
-    double wave_omega_delta = GetOmegaDelta();
-    double freq_index_des   = (regular_wave_omega_ / wave_omega_delta) - 1;
+    // the h5 frequencies may be non-uniform and may not start at the first BEM frequency
+    FrequencyTable::Interp freq = hydro_data_->GetFrequencyTable().Lookup(regular_wave_omega_);
+    // the second index of the excitation coefficients is the wave heading
+    HeadingInterp heading = GetHeadingInterp(hydro_data_->GetSimulationInfo().wave_headings, regular_wave_heading_);
     for (int b = 0; b < num_bodies_; b++) {
+        const auto& reg = hydro_data_->GetRegularWaveInfos()[b];
         for (int rowEx = 0; rowEx < 6; rowEx++) {
             int body_offset = 6 * b;
-            // why are these always 0? vvv TODO check/change this
-            excitation_force_mag_[body_offset + rowEx]   = GetExcitationMagInterp(b, rowEx, 0, freq_index_des);
-            excitation_force_phase_[body_offset + rowEx] = GetExcitationPhaseInterp(b, rowEx, 0, freq_index_des);
+            InterpolateExcitation(reg, rowEx, heading, freq, excitation_force_mag_[body_offset + rowEx],
+                                  excitation_force_phase_[body_offset + rowEx]);
         }
     }
 }
 
 Eigen::Vector3d RegularWave::GetVelocity(const Eigen::Vector3d& position, double time) {
-    return GetWaterVelocity(position, time, regular_wave_omega_, regular_wave_amplitude_, regular_wave_phase_,
-                            wavenumber_, water_depth_, mwl_);
+    Eigen::MatrixX3d velocities;
+    GetVelocities(position.transpose(), time, velocities);
+    return velocities.row(0).transpose();
 };
 
 Eigen::Vector3d RegularWave::GetAcceleration(const Eigen::Vector3d& position, double time) {
-    return GetWaterAcceleration(position, time, regular_wave_omega_, regular_wave_amplitude_, regular_wave_phase_,
-                                wavenumber_, water_depth_, mwl_);
+    Eigen::MatrixX3d accelerations;
+    GetAccelerations(position.transpose(), time, accelerations);
+    return accelerations.row(0).transpose();
 };
 
 double RegularWave::GetElevation(const Eigen::Vector3d& position, double time) {
-    return GetEta(position, time, regular_wave_omega_, regular_wave_amplitude_, regular_wave_phase_, wavenumber_);
+    Eigen::VectorXd elevations;
+    GetElevations(position.transpose(), time, elevations);
+    return elevations[0];
 };
 
+void RegularWave::GetElevations(const Eigen::MatrixX3d& positions, double time, Eigen::VectorXd& elevations) {
+    // wave travelling along regular_wave_heading_
+    Eigen::ArrayXd arg = GetComponentArguments(positions, wavenumber_, heading_cos_, heading_sin_, regular_wave_omega_,
+                                               time, regular_wave_phase_);
+    Eigen::ArrayXd sin_arg, cos_arg;
+    hydroc::SinCos(arg, sin_arg, cos_arg);
+    elevations = (regular_wave_amplitude_ * cos_arg).matrix();
+}
+
+void RegularWave::GetVelocities(const Eigen::MatrixX3d& positions, double time, Eigen::MatrixX3d& velocities) {
+    Eigen::ArrayXd arg = GetComponentArguments(positions, wavenumber_, heading_cos_, heading_sin_, regular_wave_omega_,
+                                               time, regular_wave_phase_);
+    Eigen::ArrayXd sin_arg, cos_arg, horizontal, vertical;
+    hydroc::SinCos(arg, sin_arg, cos_arg);
+    GetDepthFactors(wavenumber_, water_depth_, positions.col(2).array() - mwl_, horizontal, vertical);
+
+    // horizontal velocity along the heading
+    double omega_amplitude             = regular_wave_omega_ * regular_wave_amplitude_;
+    Eigen::ArrayXd horizontal_velocity = omega_amplitude * horizontal * cos_arg;
+    velocities.resize(positions.rows(), 3);
+    velocities.col(0) = heading_cos_ * horizontal_velocity;
+    velocities.col(1) = heading_sin_ * horizontal_velocity;
+    velocities.col(2) = omega_amplitude * vertical * sin_arg;
+}
+
+void RegularWave::GetAccelerations(const Eigen::MatrixX3d& positions, double time, Eigen::MatrixX3d& accelerations) {
+    Eigen::ArrayXd arg = GetComponentArguments(positions, wavenumber_, heading_cos_, heading_sin_, regular_wave_omega_,
+                                               time, regular_wave_phase_);
+    Eigen::ArrayXd sin_arg, cos_arg, horizontal, vertical;
+    hydroc::SinCos(arg, sin_arg, cos_arg);
+    GetDepthFactors(wavenumber_, water_depth_, positions.col(2).array() - mwl_, horizontal, vertical);
+
+    // horizontal acceleration along the heading
+    double omega2_amplitude                = regular_wave_omega_ * regular_wave_omega_ * regular_wave_amplitude_;
+    Eigen::ArrayXd horizontal_acceleration = omega2_amplitude * horizontal * sin_arg;
+    accelerations.resize(positions.rows(), 3);
+    accelerations.col(0) = heading_cos_ * horizontal_acceleration;
+    accelerations.col(1) = heading_sin_ * horizontal_acceleration;
+    accelerations.col(2) = -omega2_amplitude * vertical * cos_arg;
+}
+
 Eigen::VectorXd RegularWave::GetForceAtTime(double t) {
-    unsigned int dof = num_bodies_ * 6;
-    Eigen::VectorXd f(dof);
-    // initialize the force here:
-    for (int b = 0; b < num_bodies_; b++) {
-        int body_offset = 6 * b;
-        for (int rowEx = 0; rowEx < 6; rowEx++) {
-            f[body_offset + rowEx] = excitation_force_mag_[body_offset + rowEx] * regular_wave_amplitude_ *
-                                     cos(regular_wave_omega_ * t + excitation_force_phase_[rowEx]);
+    if (t == phasor_time_) {
+        return force_;
+    }
+
+    // time steps are accumulated in floating point, so allow for round-off when comparing them
+    double dt          = t - phasor_time_;
+    bool constant_step = std::abs(dt - phasor_dt_) <= 1e-9 * std::abs(phasor_dt_);
+    if (constant_step && steps_since_anchor_ < excitation_reanchor_steps_) {
+        time_phasor_ *= step_rotation_;
+        steps_since_anchor_++;
+    } else {
+        time_phasor_ = std::polar(1.0, regular_wave_omega_ * t);
+        if (!constant_step) {
+            phasor_dt_     = dt;
+            step_rotation_ = std::polar(1.0, regular_wave_omega_ * dt);
         }
+        steps_since_anchor_ = 0;
     }
-    return f;
+    phasor_time_ = t;
+
+    // Re(c * A * exp(i omega t)) = A * (Re(c) cos(omega t) - Im(c) sin(omega t))
+    double cos_part = regular_wave_amplitude_ * time_phasor_.real();
+    double sin_part = regular_wave_amplitude_ * time_phasor_.imag();
+    force_          = cos_part * excitation_coef_re_ - sin_part * excitation_coef_im_;
+    return force_;
 }
 
-double RegularWave::GetOmegaDelta() const {
-    double omega_max = wave_info_[0].freq_list[wave_info_[0].freq_list.size() - 1];
-    double num_freqs = wave_info_[0].freq_list.size();
-    return omega_max / num_freqs;
+PolychromaticWave::PolychromaticWave() {
+    num_bodies_ = 1;
 }
 
-double RegularWave::GetExcitationMagInterp(int b, int i, int j, double freq_index_des) const {
-    double freq_interp_val    = freq_index_des - floor(freq_index_des);
-    double excitationMagFloor = wave_info_[b].excitation_mag_matrix(i, j, (int)floor(freq_index_des));
-    double excitationMagCeil  = wave_info_[b].excitation_mag_matrix(i, j, (int)floor(freq_index_des) + 1);
-    double excitationMag      = (freq_interp_val * (excitationMagCeil - excitationMagFloor)) + excitationMagFloor;
+PolychromaticWave::PolychromaticWave(unsigned int num_b) {
+    num_bodies_ = num_b;
+}
 
-    return excitationMag;
+void PolychromaticWave::AddH5Data(std::shared_ptr<const HydroData> hydro_data) {
+    hydro_data_  = std::move(hydro_data);
+    water_depth_ = hydro_data_->GetSimulationInfo().water_depth;
+    g_           = hydro_data_->GetSimulationInfo().g;
 }
 
-double RegularWave::GetExcitationPhaseInterp(int b, int i, int j, double freq_index_des) const {
-    double freq_interp_val      = freq_index_des - floor(freq_index_des);  // look into c++ modf TODO
-    double excitationPhaseFloor = wave_info_[b].excitation_phase_matrix(
-        i, j, (int)floor(freq_index_des));  // TODO check if freq_index_des is >0, if so just cast instead of floor
-    double excitationPhaseCeil = wave_info_[b].excitation_phase_matrix(i, j, (int)floor(freq_index_des) + 1);
-    double excitationPhase = (freq_interp_val * (excitationPhaseCeil - excitationPhaseFloor)) + excitationPhaseFloor;
+void PolychromaticWave::Initialize() {
+    int num_components = component_omegas_.size();
+    if (component_amplitudes_.size() != num_components ||
+        (component_phases_.size() != 0 && component_phases_.size() != num_components)) {
+        throw std::runtime_error("Polychromatic wave: " + std::to_string(num_components) + " component frequencies, " +
+                                 std::to_string(component_amplitudes_.size()) + " amplitudes and " +
+                                 std::to_string(component_phases_.size()) + " phases.");
+    }
+    phases_ = component_phases_.size() == 0 ? Eigen::VectorXd::Zero(num_components) : component_phases_;
+
+    wavenumbers_ = DispersionSolver::Get(water_depth_, g_)->GetWaveNumbers(component_omegas_);
+
+    // the kinematics travel along the heading
+    heading_cos_ = std::cos(wave_heading_ * M_PI / 180.0);
+    heading_sin_ = std::sin(wave_heading_ * M_PI / 180.0);
+
+    // excitation of each component, the heading is the same for all components
+    HeadingInterp heading = GetHeadingInterp(hydro_data_->GetSimulationInfo().wave_headings, wave_heading_);
+    int total_dofs        = 6 * num_bodies_;
+    excitation_coef_re_.resize(total_dofs, num_components);
+    excitation_coef_im_.resize(total_dofs, num_components);
+    for (int c = 0; c < num_components; c++) {
+        FrequencyTable::Interp freq = hydro_data_->GetFrequencyTable().Lookup(component_omegas_[c]);
+        for (int b = 0; b < num_bodies_; b++) {
+            const auto& reg = hydro_data_->GetRegularWaveInfos()[b];
+            for (int dof = 0; dof < 6; dof++) {
+                double mag, phase;
+                InterpolateExcitation(reg, dof, heading, freq, mag, phase);
+                // the elevation at x = 0 is A cos(omega t - phi), so the component phase lags the force
+                excitation_coef_re_(6 * b + dof, c) = component_amplitudes_[c] * mag * cos(phase - phases_[c]);
+                excitation_coef_im_(6 * b + dof, c) = component_amplitudes_[c] * mag * sin(phase - phases_[c]);
+            }
+        }
+    }
 
-    return excitationPhase;
+    force_.setZero(total_dofs);
+    cos_buffer_.resize(num_components);
+    sin_buffer_.resize(num_components);
 }
 
-Eigen::VectorXd ComputeWaveNumbers(const Eigen::VectorXd& omegas,
-                                   double water_depth,
-                                   double g,
-                                   double tolerance   = 1e-6,
-                                   int max_iterations = 100) {
-    Eigen::VectorXd wavenumbers(omegas.size());
-    for (size_t i = 0; i < omegas.size(); ++i) {
-        wavenumbers[i] = ComputeWaveNumber(omegas[i], water_depth, g, tolerance, max_iterations);
+Eigen::VectorXd PolychromaticWave::GetForceAtTime(double t) {
+    // sum_c Re(coef_c * exp(i omega_c t))
+    hydroc::SinCos(component_omegas_.array() * t, sin_buffer_, cos_buffer_);
+    force_.noalias() = excitation_coef_re_ * cos_buffer_.matrix() - excitation_coef_im_ * sin_buffer_.matrix();
+    return force_;
+}
+
+double PolychromaticWave::GetElevation(const Eigen::Vector3d& position, double time) {
+    Eigen::VectorXd elevations;
+    GetElevations(position.transpose(), time, elevations);
+    return elevations[0];
+}
+
+Eigen::Vector3d PolychromaticWave::GetVelocity(const Eigen::Vector3d& position, double time) {
+    Eigen::MatrixX3d velocities;
+    GetVelocities(position.transpose(), time, velocities);
+    return velocities.row(0).transpose();
+}
+
+Eigen::Vector3d PolychromaticWave::GetAcceleration(const Eigen::Vector3d& position, double time) {
+    Eigen::MatrixX3d accelerations;
+    GetAccelerations(position.transpose(), time, accelerations);
+    return accelerations.row(0).transpose();
+}
+
+void PolychromaticWave::GetElevations(const Eigen::MatrixX3d& positions, double time, Eigen::VectorXd& elevations) {
+    // sum of the regular wave components, all travelling along wave_heading_
+    Eigen::ArrayXd sin_arg, cos_arg;
+    elevations.setZero(positions.rows());
+    for (int c = 0; c < wavenumbers_.size(); c++) {
+        hydroc::SinCos(GetComponentArguments(positions, wavenumbers_[c], heading_cos_, heading_sin_,
+                                             component_omegas_[c], time, phases_[c]),
+                       sin_arg, cos_arg);
+        elevations.array() += component_amplitudes_[c] * cos_arg;
+    }
+}
+
+void PolychromaticWave::GetVelocities(const Eigen::MatrixX3d& positions, double time, Eigen::MatrixX3d& velocities) {
+    Eigen::ArrayXd z = positions.col(2).array() - mwl_;
+    Eigen::ArrayXd sin_arg, cos_arg, horizontal, vertical;
+    Eigen::ArrayXd horizontal_velocity = Eigen::ArrayXd::Zero(positions.rows());
+    velocities.setZero(positions.rows(), 3);
+    for (int c = 0; c < wavenumbers_.size(); c++) {
+        hydroc::SinCos(GetComponentArguments(positions, wavenumbers_[c], heading_cos_, heading_sin_,
+                                             component_omegas_[c], time, phases_[c]),
+                       sin_arg, cos_arg);
+        GetDepthFactors(wavenumbers_[c], water_depth_, z, horizontal, vertical);
+        double omega_amplitude = component_omegas_[c] * component_amplitudes_[c];
+        horizontal_velocity += omega_amplitude * horizontal * cos_arg;
+        velocities.col(2).array() += omega_amplitude * vertical * sin_arg;
     }
-    return wavenumbers;
+    // horizontal kinematics along the heading
+    velocities.col(0) = heading_cos_ * horizontal_velocity;
+    velocities.col(1) = heading_sin_ * horizontal_velocity;
+}
+
+void PolychromaticWave::GetAccelerations(const Eigen::MatrixX3d& positions,
+                                         double time,
+                                         Eigen::MatrixX3d& accelerations) {
+    Eigen::ArrayXd z = positions.col(2).array() - mwl_;
+    Eigen::ArrayXd sin_arg, cos_arg, horizontal, vertical;
+    Eigen::ArrayXd horizontal_acceleration = Eigen::ArrayXd::Zero(positions.rows());
+    accelerations.setZero(positions.rows(), 3);
+    for (int c = 0; c < wavenumbers_.size(); c++) {
+        hydroc::SinCos(GetComponentArguments(positions, wavenumbers_[c], heading_cos_, heading_sin_,
+                                             component_omegas_[c], time, phases_[c]),
+                       sin_arg, cos_arg);
+        GetDepthFactors(wavenumbers_[c], water_depth_, z, horizontal, vertical);
+        double omega2_amplitude = component_omegas_[c] * component_omegas_[c] * component_amplitudes_[c];
+        horizontal_acceleration += omega2_amplitude * horizontal * sin_arg;
+        accelerations.col(2).array() -= omega2_amplitude * vertical * cos_arg;
+    }
+    // horizontal kinematics along the heading
+    accelerations.col(0) = heading_cos_ * horizontal_acceleration;
+    accelerations.col(1) = heading_sin_ * horizontal_acceleration;
 }
 
 std::vector<std::array<double, 3>> CreateFreeSurface3DPts(const std::vector<double>& eta,
@@ -358,35 +575,271 @@ void WriteFreeSurfaceMeshObj(const std::vector<std::array<double, 3>>& points,
     out.close();
 }
 
+namespace {
+
+// binary eta file: header, then the times and the elevations
+const char kEtaMagic[8]          = {'H', 'C', 'E', 'T', 'A', '\0', '\0', '\0'};
+const uint32_t kEtaFormatVersion = 1;
+
+struct EtaHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t num_samples;
+};
+
+enum class EtaFormat { text, binary, hdf5 };
+
+EtaFormat GetEtaFormat(const std::string& file_name) {
+    std::string extension = std::filesystem::path(file_name).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    if (extension == ".bin") {
+        return EtaFormat::binary;
+    }
+    if (extension == ".h5" || extension == ".hdf5") {
+        return EtaFormat::hdf5;
+    }
+    return EtaFormat::text;
+}
+
+// "time : eta" lines parsed in place with std::from_chars, blank lines are skipped
+void ReadEtaText(const std::string& file_name, std::vector<double>& times, std::vector<double>& eta) {
+    hydroc::MappedFile mapped(file_name);
+    const char* data = mapped.GetData();
+    const char* end  = data + mapped.GetSize();
+
+    size_t num_lines = std::count(data, end, '\n') + 1;
+    times.reserve(num_lines);
+    eta.reserve(num_lines);
+
+    auto skip_blanks = [&](const char* p) {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+            p++;
+        }
+        return p;
+    };
+
+    size_t line_number = 0;
+    const char* p      = data;
+    while (p < end) {
+        line_number++;
+        const char* line_end = std::find(p, end, '\n');
+        p                    = skip_blanks(p);
+        if (p == line_end) {
+            p = line_end + 1;
+            continue;
+        }
+        double time, value;
+        auto time_result = std::from_chars(p, line_end, time);
+        p                = skip_blanks(time_result.ptr);
+        bool parsed      = time_result.ec == std::errc() && p < line_end && *p == ':';
+        if (parsed) {
+            auto value_result = std::from_chars(skip_blanks(p + 1), line_end, value);
+            parsed            = value_result.ec == std::errc() && skip_blanks(value_result.ptr) == line_end;
+        }
+        if (!parsed) {
+            throw std::runtime_error("Could not parse line " + std::to_string(line_number) + " of " + file_name + ".");
+        }
+        times.push_back(time);
+        eta.push_back(value);
+        p = line_end + 1;
+    }
+}
+
+void ReadEtaBinary(const std::string& file_name, std::vector<double>& times, std::vector<double>& eta) {
+    hydroc::MappedFile mapped(file_name);
+    EtaHeader header;
+    if (mapped.GetSize() < sizeof(EtaHeader)) {
+        throw std::runtime_error("Eta file " + file_name + " is too short.");
+    }
+    std::memcpy(&header, mapped.GetData(), sizeof(EtaHeader));
+    if (std::memcmp(header.magic, kEtaMagic, sizeof(kEtaMagic)) != 0 || header.version != kEtaFormatVersion ||
+        mapped.GetSize() != sizeof(EtaHeader) + 2 * header.num_samples * sizeof(double)) {
+        throw std::runtime_error("Eta file " + file_name + " is not a binary eta file.");
+    }
+    const char* samples = mapped.GetData() + sizeof(EtaHeader);
+    times.resize(header.num_samples);
+    eta.resize(header.num_samples);
+    std::memcpy(times.data(), samples, header.num_samples * sizeof(double));
+    std::memcpy(eta.data(), samples + header.num_samples * sizeof(double), header.num_samples * sizeof(double));
+}
+
+void ReadEtaHDF5(const std::string& file_name, std::vector<double>& times, std::vector<double>& eta) {
+    H5::H5File file(file_name, H5F_ACC_RDONLY);
+    auto read_dataset = [&](const std::string& name, std::vector<double>& values) {
+        H5::DataSet dataset     = file.openDataSet(name);
+        H5::DataSpace filespace = dataset.getSpace();
+        values.resize(filespace.getSimpleExtentNpoints());
+        dataset.read(values.data(), H5::PredType::NATIVE_DOUBLE);
+    };
+    read_dataset("time", times);
+    read_dataset("eta", eta);
+}
+
+}  // namespace
+
+void ReadEtaFile(const std::string& file_name, std::vector<double>& times, std::vector<double>& eta) {
+    times.clear();
+    eta.clear();
+    try {
+        switch (GetEtaFormat(file_name)) {
+            case EtaFormat::binary:
+                ReadEtaBinary(file_name, times, eta);
+                break;
+            case EtaFormat::hdf5:
+                ReadEtaHDF5(file_name, times, eta);
+                break;
+            case EtaFormat::text:
+                ReadEtaText(file_name, times, eta);
+                break;
+        }
+    } catch (const H5::Exception& e) {
+        throw std::runtime_error("Unable to read eta file " + file_name + ": " + e.getDetailMsg() + ".");
+    }
+    if (times.size() != eta.size()) {
+        throw std::runtime_error("Eta file " + file_name + " has " + std::to_string(times.size()) + " times and " +
+                                 std::to_string(eta.size()) + " elevations.");
+    }
+}
+
+void WriteEtaFile(const std::string& file_name, const std::vector<double>& times, const std::vector<double>& eta) {
+    if (times.size() != eta.size()) {
+        throw std::runtime_error("Eta file: " + std::to_string(times.size()) + " times and " +
+                                 std::to_string(eta.size()) + " elevations.");
+    }
+    EtaFormat format = GetEtaFormat(file_name);
+    if (format == EtaFormat::hdf5) {
+        try {
+            H5::H5File file(file_name, H5F_ACC_TRUNC);
+            hsize_t dims[1] = {times.size()};
+            H5::DataSpace space(1, dims);
+            auto write_dataset = [&](const std::string& name, const std::vector<double>& values) {
+                file.createDataSet(name, H5::PredType::NATIVE_DOUBLE, space)
+                    .write(values.data(), H5::PredType::NATIVE_DOUBLE);
+            };
+            write_dataset("time", times);
+            write_dataset("eta", eta);
+        } catch (const H5::Exception& e) {
+            throw std::runtime_error("Unable to write eta file " + file_name + ": " + e.getDetailMsg() + ".");
+        }
+        return;
+    }
+
+    std::ofstream out(file_name, format == EtaFormat::binary ? std::ios::binary : std::ios::out);
+    if (!out) {
+        throw std::runtime_error("Unable to open eta file " + file_name + " for writing.");
+    }
+    if (format == EtaFormat::binary) {
+        EtaHeader header = {};
+        std::memcpy(header.magic, kEtaMagic, sizeof(kEtaMagic));
+        header.version     = kEtaFormatVersion;
+        header.num_samples = times.size();
+        out.write(reinterpret_cast<const char*>(&header), sizeof(EtaHeader));
+        out.write(reinterpret_cast<const char*>(times.data()), times.size() * sizeof(double));
+        out.write(reinterpret_cast<const char*>(eta.data()), eta.size() * sizeof(double));
+    } else {
+        // shortest representation that reads back to the same doubles
+        char buffer[64];
+        for (size_t i = 0; i < times.size(); i++) {
+            char* p = std::to_chars(buffer, buffer + sizeof(buffer), times[i]).ptr;
+            p       = std::copy_n(" : ", 3, p);
+            p       = std::to_chars(p, buffer + sizeof(buffer), eta[i]).ptr;
+            *p++    = '\n';
+            out.write(buffer, p - buffer);
+        }
+    }
+    if (!out) {
+        throw std::runtime_error("Unable to write eta file " + file_name + ".");
+    }
+}
+
 IrregularWaves::IrregularWaves(const IrregularWaveParams& params) : params_(params) {}
 
 void IrregularWaves::InitializeIRFVectors() {
     ex_irf_sampled_.resize(params_.num_bodies_);
     ex_irf_time_sampled_.resize(params_.num_bodies_);
     ex_irf_width_sampled_.resize(params_.num_bodies_);
+    ex_irf_weighted_.resize(params_.num_bodies_);
 
-    std::vector<Eigen::MatrixXd> ex_irf_old(params_.num_bodies_);
-    std::vector<Eigen::VectorXd> ex_irf_time_old(params_.num_bodies_);
-
+    // view the h5 IRFs until they are resampled
     for (unsigned int b = 0; b < params_.num_bodies_; b++) {
-        ex_irf_sampled_[b]      = GetExcitationIRF(b);
-        ex_irf_time_sampled_[b] = wave_info_[b].excitation_irf_time;
-        CalculateWidthIRF();
+        const auto& info        = hydro_data_->GetIrregularWaveInfos()[b];
+        ex_irf_sampled_[b]      = info.excitation_irf_matrix;
+        ex_irf_time_sampled_[b] = std::shared_ptr<const Eigen::VectorXd>(hydro_data_, &info.excitation_irf_time);
     }
 
-    // Resample excitation IRF time series
-    if (params_.simulation_dt_ > 0.0) {
+    if (params_.frequency_domain_excitation_ && !params_.eta_file_path_.empty()) {
+        throw std::runtime_error(
+            "Irregular waves: the frequency domain excitation needs a wave spectrum, it cannot be used with an eta "
+            "file.");
+    }
+
+    // Resample excitation IRF time series (not used by the frequency domain excitation)
+    if (params_.simulation_dt_ > 0.0 && !params_.frequency_domain_excitation_) {
         ResampleIRF(params_.simulation_dt_);
+    } else {
+        CalculateWidthIRF();
+    }
+
+    if (!params_.eta_reference_positions_.empty() &&
+        params_.eta_reference_positions_.size() != static_cast<size_t>(params_.num_bodies_)) {
+        throw std::runtime_error("Irregular waves: " + std::to_string(params_.eta_reference_positions_.size()) +
+                                 " eta reference positions for " + std::to_string(params_.num_bodies_) + " bodies.");
+    }
+
+    if (params_.precompute_excitation_force_ && params_.streaming_free_surface_) {
+        throw std::runtime_error(
+            "Irregular waves: the excitation force cannot be precomputed from a streamed free surface elevation.");
+    }
+
+    if (params_.streaming_free_surface_ && params_.nfrequencies_ == 0) {
+        // the automatic number of frequencies grows with the simulation duration, and so would the cost of each block
+        throw std::runtime_error("Irregular waves: a streamed free surface elevation needs an explicit nfrequencies_.");
     }
 
     if (!params_.eta_file_path_.empty()) {
+        if (!params_.eta_reference_positions_.empty()) {
+            throw std::runtime_error(
+                "Irregular waves: eta reference positions need a wave spectrum, they cannot be used with an eta "
+                "file.");
+        }
         ReadEtaFromFile();
         spectrumCreated_ = false;
+        if (params_.precompute_excitation_force_) {
+            PrecomputeExcitationForce();
+        }
     } else if (params_.wave_height_ != 0.0 && params_.wave_period_ != 0.0) {
         CreateSpectrum();
+        frequency_domain_force_ = params_.frequency_domain_excitation_ || directional_;
+        spectrumCreated_        = true;
+    }
+}
+
+void IrregularWaves::InitializeRealization() {
+    if (frequency_domain_force_) {
+        ComputeExcitationCoefficients();
+    }
+    if (!params_.frequency_domain_excitation_) {
         CreateFreeSurfaceElevation();
-        spectrumCreated_ = true;
     }
+    if (params_.precompute_excitation_force_ && !frequency_domain_force_) {
+        PrecomputeExcitationForce();
+    }
+}
+
+std::shared_ptr<IrregularWaves> IrregularWaves::CreateRealization(int seed) const {
+    if (!spectrumCreated_) {
+        throw std::runtime_error(
+            "Irregular waves: realizations need a wave spectrum, call AddH5Data() with a wave height and period "
+            "first.");
+    }
+    auto realization           = std::make_shared<IrregularWaves>(*this);
+    realization->params_.seed_ = seed;
+    // the diagnostics sink is shared with this wave, concurrent realizations would write the same series
+    realization->params_.diagnostics_ = nullptr;
+    realization->CreateWavePhases();
+    realization->InitializeRealization();
+    return realization;
 }
 
 std::vector<double> IrregularWaves::GetSpectrum() {
@@ -405,79 +858,166 @@ std::vector<double> IrregularWaves::GetEtaTimeData() {
     return time_data_;
 }
 
-void IrregularWaves::ReadEtaFromFile() {
-    std::cout << "Reading eta file " << params_.eta_file_path_ << "." << std::endl;
-    std::ifstream file(params_.eta_file_path_);
-    if (!file) {
-        throw std::runtime_error("Unable to open file at: " + params_.eta_file_path_ + ".");
+std::vector<double> IrregularWaves::GetFreeSurfaceElevation(int body) {
+    if (body_free_surface_elevation_sampled_.empty()) {
+        return free_surface_elevation_sampled_;
     }
+    return body_free_surface_elevation_sampled_.at(body);
+}
 
-    std::string line;
-    double time, eta;
+std::vector<double> IrregularWaves::GetFreeSurfaceTime() {
+    return free_surface_time_sampled_;
+}
 
-    while (std::getline(file, line)) {
-        std::stringstream ss(line);
-        char delimiter;
-        if (!(ss >> time >> delimiter >> eta) || delimiter != ':') {
-            throw std::runtime_error("Could not parse line: " + line + ".");
-        }
-        time_data_.push_back(time);
-        free_surface_elevation_sampled_.push_back(eta);
+void IrregularWaves::ReadEtaFromFile() {
+    std::cout << "Reading eta file " << params_.eta_file_path_ << "." << std::endl;
+    ReadEtaFile(params_.eta_file_path_, time_data_, free_surface_elevation_sampled_);
+    if (time_data_.size() < 2) {
+        throw std::runtime_error("Eta file " + params_.eta_file_path_ + " needs at least two samples.");
     }
+    // the convolution reads the elevation on free_surface_time_sampled_
+    free_surface_time_sampled_ = time_data_;
     std::cout << "Finished reading eta file." << std::endl;
 }
 
-Eigen::MatrixXd IrregularWaves::GetExcitationIRF(int b) const {
-    return wave_info_[b].excitation_irf_matrix;
+void IrregularWaves::AddH5Data(std::shared_ptr<const HydroData> hydro_data) {
+    SetUpSeaState(std::move(hydro_data));
+    if (spectrumCreated_) {
+        InitializeRealization();
+    }
 }
 
-void IrregularWaves::AddH5Data(std::vector<HydroData::IrregularWaveInfo>& irreg_h5_data,
-                               HydroData::SimulationParameters& sim_data) {
-    wave_info_   = irreg_h5_data;
-    water_depth_ = sim_data.water_depth;
-    g_           = sim_data.g;
+void IrregularWaves::SetUpSeaState(std::shared_ptr<const HydroData> hydro_data) {
+    hydro_data_  = std::move(hydro_data);
+    water_depth_ = hydro_data_->GetSimulationInfo().water_depth;
+    g_           = hydro_data_->GetSimulationInfo().g;
 
     InitializeIRFVectors();
 }
 
-Eigen::Vector3d IrregularWaves::GetVelocity(const Eigen::Vector3d& position, double time) {
-    // apply wave stretching (if enabled)
-    auto position_stretched = position;
+void IrregularWaves::SetTimePhases(double time) {
+    time_phases_ = wave_phases_.array() - component_omegas_ * time;
+}
+
+void IrregularWaves::ComputeComponentPhases(double x, double y) {
+    hydroc::SinCos(component_wavenumbers_x_ * x + component_wavenumbers_y_ * y + time_phases_, sin_buffer_,
+                   cos_buffer_);
+}
+
+void IrregularWaves::ComputeDepthFactors(double z, Eigen::ArrayXd& horizontal, Eigen::ArrayXd& vertical) const {
+    Eigen::ArrayXd decay  = (component_wavenumbers_ * z).exp() * inv_depth_denominators_;
+    Eigen::ArrayXd bottom = shallow_water_.select((-2.0 * component_wavenumbers_ * (z + water_depth_)).exp(), 0.0);
+    horizontal            = decay * (1.0 + bottom);
+    vertical              = decay * (1.0 - bottom);
+}
+
+WaveKinematics IrregularWaves::ComputeKinematics(const Eigen::Vector3d& position) {
+    ComputeComponentPhases(position.x(), position.y());
+
+    WaveKinematics kinematics;
+    kinematics.elevation = (component_amplitudes_ * cos_buffer_).sum();
+
+    // position relative to mean water level
+    double z_pos = position.z() - mwl_;
     if (params_.wave_stretching_) {
-        auto eta = GetEtaIrregular(position, time, spectrum_frequencies_, spectral_densities_, spectral_widths_,
-                                   wave_phases_, wavenumbers_);
-        // position relative to mean water level
-        auto z_pos = position.z() - mwl_;
         // Wheeler stretching
-        position_stretched[2] = water_depth_ * (z_pos - eta) / (water_depth_ + eta);
+        z_pos = water_depth_ * (z_pos - kinematics.elevation) / (water_depth_ + kinematics.elevation);
     }
+    ComputeDepthFactors(z_pos, horizontal_buffer_, vertical_buffer_);
+
+    // horizontal kinematics along the direction of each component
+    Eigen::ArrayXd horizontal_velocity     = omega_amplitudes_ * horizontal_buffer_ * cos_buffer_;
+    Eigen::ArrayXd horizontal_acceleration = omega2_amplitudes_ * horizontal_buffer_ * sin_buffer_;
+    kinematics.velocity     = Eigen::Vector3d((horizontal_velocity * component_cos_directions_).sum(),
+                                              (horizontal_velocity * component_sin_directions_).sum(),
+                                              (omega_amplitudes_ * vertical_buffer_ * sin_buffer_).sum());
+    kinematics.acceleration =
+        Eigen::Vector3d((horizontal_acceleration * component_cos_directions_).sum(),
+                        (horizontal_acceleration * component_sin_directions_).sum(),
+                        -(omega2_amplitudes_ * vertical_buffer_ * cos_buffer_).sum());
+    return kinematics;
+}
 
-    return GetWaterVelocityIrregular(position_stretched, time, spectrum_frequencies_, spectral_densities_,
-                                     spectral_widths_, wave_phases_, wavenumbers_, water_depth_, mwl_);
+Eigen::Vector3d IrregularWaves::GetVelocity(const Eigen::Vector3d& position, double time) {
+    SetTimePhases(time);
+    return ComputeKinematics(position).velocity;
 };
 
 Eigen::Vector3d IrregularWaves::GetAcceleration(const Eigen::Vector3d& position, double time) {
-    // apply wave stretching (if enabled)
-    auto position_stretched = position;
-    if (params_.wave_stretching_) {
-        auto eta = GetEtaIrregular(position, time, spectrum_frequencies_, spectral_densities_, spectral_widths_,
-                                   wave_phases_, wavenumbers_);
-        // position relative to mean water level
-        auto z_pos = position.z() - mwl_;
-        // Wheeler stretching
-        position_stretched[2] = water_depth_ * (z_pos - eta) / (water_depth_ + eta);
-    }
-
-    return GetWaterAccelerationIrregular(position_stretched, time, spectrum_frequencies_, spectral_densities_,
-                                         spectral_widths_, wave_phases_, wavenumbers_, water_depth_, mwl_);
+    SetTimePhases(time);
+    return ComputeKinematics(position).acceleration;
 };
 
+WaveKinematics IrregularWaves::GetKinematics(const Eigen::Vector3d& position, double time) {
+    SetTimePhases(time);
+    return ComputeKinematics(position);
+}
+
 double IrregularWaves::GetElevation(const Eigen::Vector3d& position, double time) {
-    return GetEtaIrregular(position, time, spectrum_frequencies_, spectral_densities_, spectral_widths_, wave_phases_,
-                           wavenumbers_);
+    SetTimePhases(time);
+    ComputeComponentPhases(position.x(), position.y());
+    return (component_amplitudes_ * cos_buffer_).sum();
 };
 
+void IrregularWaves::GetElevations(const Eigen::MatrixX3d& positions, double time, Eigen::VectorXd& elevations) {
+    SetTimePhases(time);
+    elevations.resize(positions.rows());
+    for (Eigen::Index p = 0; p < positions.rows(); p++) {
+        ComputeComponentPhases(positions(p, 0), positions(p, 1));
+        elevations[p] = (component_amplitudes_ * cos_buffer_).sum();
+    }
+}
+
+void IrregularWaves::GetVelocities(const Eigen::MatrixX3d& positions, double time, Eigen::MatrixX3d& velocities) {
+    SetTimePhases(time);
+    velocities.resize(positions.rows(), 3);
+    for (Eigen::Index p = 0; p < positions.rows(); p++) {
+        velocities.row(p) = ComputeKinematics(positions.row(p).transpose()).velocity.transpose();
+    }
+}
+
+void IrregularWaves::GetAccelerations(const Eigen::MatrixX3d& positions, double time, Eigen::MatrixX3d& accelerations) {
+    SetTimePhases(time);
+    accelerations.resize(positions.rows(), 3);
+    for (Eigen::Index p = 0; p < positions.rows(); p++) {
+        accelerations.row(p) = ComputeKinematics(positions.row(p).transpose()).acceleration.transpose();
+    }
+}
+
 Eigen::VectorXd IrregularWaves::GetForceAtTime(double t) {
+    if (frequency_domain_force_) {
+        // sum_i Re(coef_i * exp(i omega_i t)), ramped up over ramp_duration_ (the convolution ramps the elevation
+        // instead, see IrregularWaveParams::frequency_domain_excitation_)
+        hydroc::SinCos(spectrum_omegas_ * t, force_sin_buffer_, force_cos_buffer_);
+        force_.noalias() =
+            excitation_coef_re_ * force_cos_buffer_.matrix() - excitation_coef_im_ * force_sin_buffer_.matrix();
+        if (params_.ramp_duration_ > 0.0 && t < params_.ramp_duration_) {
+            return std::max(t, 0.0) / params_.ramp_duration_ * force_;
+        }
+        return force_;
+    }
+
+    if (!force_series_.empty()) {
+        // linear interpolation of the precomputed force
+        Eigen::VectorXd f(params_.num_bodies_ * 6);
+        for (int body = 0; body < params_.num_bodies_; body++) {
+            const auto& series = force_series_[body];
+            double u           = (t - force_series_start_[body]) / force_series_dt_[body];
+            if (u < 0.0 || u > series.cols() - 1) {
+                throw std::runtime_error("Excitation force: time " + std::to_string(t) +
+                                         " out of bounds of the precomputed excitation force.");
+            }
+            Eigen::Index idx       = std::min<Eigen::Index>(static_cast<Eigen::Index>(u), series.cols() - 2);
+            double w2              = u - idx;
+            f.segment<6>(body * 6) = (1.0 - w2) * series.col(idx) + w2 * series.col(idx + 1);
+        }
+        return f;
+    }
+
+    if (params_.streaming_free_surface_ && spectrumCreated_) {
+        AdvanceFreeSurfaceWindow(t);
+    }
+
     unsigned int total_dofs = params_.num_bodies_ * 6;
     Eigen::VectorXd f(total_dofs);
     for (int i = 0; i < total_dofs; i++) {
@@ -485,73 +1025,30 @@ Eigen::VectorXd IrregularWaves::GetForceAtTime(double t) {
     }
 
     for (int body = 0; body < params_.num_bodies_; body++) {
-        // Loop through the DOFs
-        for (int dof = 0; dof < 6; ++dof) {
-            // Compute the convolution for the current DOF
-            double f_dof          = ExcitationConvolution(body, dof, t);
-            unsigned int b_offset = body * 6;
-            f[b_offset + dof]     = f_dof;
-        }
+        // Compute the convolution for all DOFs of the body
+        f.segment<6>(body * 6) = ExcitationConvolution(body, t);
     }
 
     return f;
 }
 
 void IrregularWaves::ResampleIRF(double dt) {
+    // resampled once per time step and shared through the h5 data, with the widths
     for (unsigned int b = 0; b < params_.num_bodies_; b++) {
-        auto& time_array  = ex_irf_time_sampled_[b];
-        auto& width_array = ex_irf_width_sampled_[b];
-        auto& val_array   = ex_irf_sampled_[b];
-
-        // Copy time array
-        auto time_array_old = time_array;
-
-        // 1) Resample time
-        auto t0    = time_array_old[0];
-        auto t1    = time_array_old[time_array_old.size() - 1];
-        time_array = Eigen::VectorXd::LinSpaced(static_cast<int>(ceil((t1 - t0) / dt)), t0, t1);
-
-        // 2) Resample width
-        CalculateWidthIRF();
-
-        // 3) Resample values
-        assert(val_array.rows() == 6);
-        Eigen::MatrixXd vals_new(6, time_array.size());
-
-        // We need to scale t to be [0,1] for spline use
-        Eigen::VectorXd t_old_scaled = Eigen::VectorXd::LinSpaced(time_array_old.size(), 0, 1);
-        Eigen::VectorXd t_new_scaled = Eigen::VectorXd::LinSpaced(time_array.size(), 0, 1);
-
-        // Use spline to get new values
-        Eigen::Spline<double, 6> spline =
-            Eigen::SplineFitting<Eigen::Spline<double, 6>>::Interpolate(val_array, 3, t_old_scaled);
-        for (int i = 0; i < time_array.rows(); i++) {
-            vals_new.col(i) = spline(t_new_scaled[i]);
-        }
-
-        val_array = vals_new;
-    }
-}
-
-Eigen::VectorXd GetWidthArray(const Eigen::VectorXd& input_array) {
-    auto width_array = Eigen::VectorXd(input_array.size());
-    for (int ii = 0; ii < width_array.size(); ii++) {
-        width_array[ii] = 0.0;
-        if (ii < input_array.size() - 1) {
-            width_array[ii] += 0.5 * abs(input_array[ii + 1] - input_array[ii]);
-        }
-        if (ii > 0) {
-            width_array[ii] += 0.5 * abs(input_array[ii] - input_array[ii - 1]);
-        }
+        auto irf                 = hydro_data_->GetResampledExcitationIRF(b, dt);
+        ex_irf_time_sampled_[b]  = irf->time;
+        ex_irf_sampled_[b]       = irf->values;
+        ex_irf_width_sampled_[b] = irf->widths;
+        ex_irf_weighted_[b]      = irf->weighted;
     }
-    return width_array;
 }
 
 void IrregularWaves::CalculateWidthIRF() {
+    // widths folded into the IRF, so the convolution is one matrix-vector product per body
     for (unsigned int b = 0; b < params_.num_bodies_; b++) {
-        auto& time_array  = ex_irf_time_sampled_[b];
-        auto& width_array = ex_irf_width_sampled_[b];
-        width_array       = GetWidthArray(time_array);
+        Eigen::VectorXd widths   = GetTrapezoidalWidths(*ex_irf_time_sampled_[b]);
+        ex_irf_width_sampled_[b] = widths;
+        ex_irf_weighted_[b]      = std::make_shared<const Eigen::MatrixXd>(*ex_irf_sampled_[b] * widths.asDiagonal());
     }
 }
 
@@ -586,35 +1083,169 @@ void IrregularWaves::CreateSpectrum() {
                                             params_.peak_enhancement_factor_, params_.is_normalized_);
 
     // precompute spectral widths
-    spectral_widths_ = GetWidthArray(spectrum_frequencies_);
+    spectral_widths_ = GetTrapezoidalWidths(spectrum_frequencies_);
 
-    // precompute random phases
-    wave_phases_ = Eigen::VectorXd(nf);
+    // directions of the components
+    CreateDirections();
+    int nd = direction_angles_.size();
+
+    // precompute random phases, one per frequency and direction
+    wave_phases_ = Eigen::VectorXd(nf * nd);
+    CreateWavePhases();
+
+    // precompute wavenumbers
+    Eigen::VectorXd omegas = 2 * M_PI * spectrum_frequencies_;
+    wavenumbers_           = DispersionSolver::Get(water_depth_, g_)->GetWaveNumbers(omegas, params_.num_threads_);
+
+    // precompute the per component constants of the kinematics, frequency i and direction j in component i nd + j
+    Eigen::ArrayXd frequency_amplitudes = (2.0 * spectral_densities_.array() * spectral_widths_.array()).sqrt();
+    component_amplitudes_.resize(nf * nd);
+    component_omegas_.resize(nf * nd);
+    component_wavenumbers_.resize(nf * nd);
+    component_cos_directions_.resize(nf * nd);
+    component_sin_directions_.resize(nf * nd);
+    for (int i = 0; i < nf; i++) {
+        for (int j = 0; j < nd; j++) {
+            int c                        = i * nd + j;
+            component_amplitudes_[c]     = frequency_amplitudes[i] * std::sqrt(direction_weights_[j]);
+            component_omegas_[c]         = omegas[i];
+            component_wavenumbers_[c]    = wavenumbers_[i];
+            component_cos_directions_[c] = std::cos(direction_angles_[j]);
+            component_sin_directions_[c] = std::sin(direction_angles_[j]);
+        }
+    }
+    spectrum_omegas_         = omegas.array();
+    component_wavenumbers_x_ = component_wavenumbers_ * component_cos_directions_;
+    component_wavenumbers_y_ = component_wavenumbers_ * component_sin_directions_;
+    omega_amplitudes_        = component_omegas_ * component_amplitudes_;
+    omega2_amplitudes_       = component_omegas_ * omega_amplitudes_;
+    shallow_water_ =
+        2 * M_PI / component_wavenumbers_ <= water_depth_ && component_wavenumbers_ * water_depth_ <= 500.0;
+    inv_depth_denominators_ =
+        shallow_water_.select(1.0 / (1.0 - (-2.0 * component_wavenumbers_ * water_depth_).exp()), 1.0);
+
+    // Write the spectral densities and their corresponding frequencies
+    if (params_.diagnostics_ != nullptr) {
+        auto to_vector = [](const Eigen::VectorXd& v) { return std::vector<double>(v.data(), v.data() + v.size()); };
+        params_.diagnostics_->WriteSeries("spectral_densities", to_vector(spectrum_frequencies_),
+                                          to_vector(spectral_densities_));
+    }
+}
+
+void IrregularWaves::CreateWavePhases() {
+    // one stream per seed, so a seed always gives the same realization
     std::mt19937 rng(params_.seed_);
     std::uniform_real_distribution<double> dist(0.0, 2 * M_PI);
-    for (size_t i = 0; i < nf; ++i) {
+    for (Eigen::Index i = 0; i < wave_phases_.size(); ++i) {
         wave_phases_[i] = dist(rng);
     }
+}
 
-    // precompute wavenumbers
-    auto omegas  = 2 * M_PI * spectrum_frequencies_;
-    wavenumbers_ = ComputeWaveNumbers(omegas, water_depth_, g_);
-
-    // Open a file stream for writing
-    std::ofstream outputFile("spectral_densities.txt");
+void IrregularWaves::CreateDirections() {
+    std::vector<double> directions, weights;
+    if (!params_.spreading_directions_.empty()) {
+        if (params_.spreading_weights_.size() != params_.spreading_directions_.size()) {
+            throw std::runtime_error("Irregular waves: " + std::to_string(params_.spreading_directions_.size()) +
+                                     " spreading directions and " + std::to_string(params_.spreading_weights_.size()) +
+                                     " weights.");
+        }
+        directions = params_.spreading_directions_;
+        weights    = params_.spreading_weights_;
+    } else if (params_.num_directions_ > 1) {
+        // cos-2s on the midpoints of num_directions_ equal sectors
+        double width = 2 * params_.spreading_range_ / params_.num_directions_;
+        for (int j = 0; j < params_.num_directions_; j++) {
+            double offset = -params_.spreading_range_ + (j + 0.5) * width;
+            directions.push_back(params_.mean_direction_ + offset);
+            weights.push_back(std::pow(std::cos(0.5 * offset * M_PI / 180.0), 2 * params_.spreading_s_));
+        }
+    } else {
+        directions.push_back(params_.mean_direction_);
+        weights.push_back(1.0);
+    }
 
-    // Check if the file stream is open
-    if (outputFile.is_open()) {
-        // Write the spectral densities and their corresponding frequencies to the file
-        for (size_t i = 0; i < spectral_densities_.size(); ++i) {
-            outputFile << spectrum_frequencies_[i] << " : " << spectral_densities_[i] << std::endl;
+    double total_weight = 0.0;
+    for (double weight : weights) {
+        if (weight < 0.0) {
+            throw std::runtime_error("Irregular waves: negative spreading weight " + std::to_string(weight) + ".");
         }
+        total_weight += weight;
+    }
+    if (total_weight <= 0.0) {
+        throw std::runtime_error("Irregular waves: spreading weights sum to zero.");
+    }
 
-        // Close the file stream
-        outputFile.close();
-    } else {
-        std::cerr << "Unable to open file for writing." << std::endl;
+    direction_angles_  = Eigen::Map<Eigen::VectorXd>(directions.data(), directions.size()) * (M_PI / 180.0);
+    direction_weights_ = Eigen::Map<Eigen::VectorXd>(weights.data(), weights.size()) / total_weight;
+    directional_ =
+        !params_.spreading_directions_.empty() || params_.num_directions_ > 1 || params_.mean_direction_ != 0.0;
+}
+
+Eigen::VectorXcd IrregularWaves::GetFrequencyAmplitudes(const Eigen::Vector3d& position) const {
+    // a cos(k.x - omega t + phi) = Re(a exp(-i (k.x + phi)) exp(i omega t))
+    int nd                      = direction_angles_.size();
+    Eigen::VectorXcd amplitudes = Eigen::VectorXcd::Zero(spectrum_omegas_.size());
+    for (int c = 0; c < component_amplitudes_.size(); c++) {
+        double phase = component_wavenumbers_x_[c] * position.x() + component_wavenumbers_y_[c] * position.y() +
+                       wave_phases_[c];
+        amplitudes[c / nd] += std::polar(component_amplitudes_[c], -phase);
+    }
+    return amplitudes;
+}
+
+void IrregularWaves::ComputeExcitationCoefficients() {
+    int nd         = direction_angles_.size();
+    int nf         = spectrum_omegas_.size();
+    int total_dofs = 6 * params_.num_bodies_;
+
+    const auto& headings = hydro_data_->GetSimulationInfo().wave_headings;
+    std::vector<HeadingInterp> heading_interps(nd);
+    for (int j = 0; j < nd; j++) {
+        heading_interps[j] = GetHeadingInterp(headings, direction_angles_[j] * 180.0 / M_PI);
+    }
+
+    const FrequencyTable& table      = hydro_data_->GetFrequencyTable();
+    const Eigen::VectorXd& h5_omegas = table.GetFrequencies();
+    double h5_omega_min              = h5_omegas[0];
+    double h5_omega_max              = h5_omegas[h5_omegas.size() - 1];
+    excitation_coef_re_.setZero(total_dofs, nf);
+    excitation_coef_im_.setZero(total_dofs, nf);
+    // components outside of the h5 frequencies have no excitation (as in the IRF convolution) instead of the
+    // excitation of the closest h5 frequency
+    double outside_energy = 0.0;
+    for (int i = 0; i < nf; i++) {
+        if (spectrum_omegas_[i] < h5_omega_min || spectrum_omegas_[i] > h5_omega_max) {
+            outside_energy += component_amplitudes_.segment(i * nd, nd).square().sum();
+            continue;
+        }
+        FrequencyTable::Interp freq = table.Lookup(spectrum_omegas_[i]);
+        for (int j = 0; j < nd; j++) {
+            int c = i * nd + j;
+            for (int b = 0; b < params_.num_bodies_; b++) {
+                // phase of the elevation at the reference position of the body (origin by default)
+                double phase_shift = wave_phases_[c];
+                if (!params_.eta_reference_positions_.empty()) {
+                    const Eigen::Vector3d& position = params_.eta_reference_positions_[b];
+                    phase_shift +=
+                        component_wavenumbers_x_[c] * position.x() + component_wavenumbers_y_[c] * position.y();
+                }
+                const auto& reg = hydro_data_->GetRegularWaveInfos()[b];
+                for (int dof = 0; dof < 6; dof++) {
+                    double mag, phase;
+                    InterpolateExcitation(reg, dof, heading_interps[j], freq, mag, phase);
+                    excitation_coef_re_(6 * b + dof, i) += component_amplitudes_[c] * mag * cos(phase - phase_shift);
+                    excitation_coef_im_(6 * b + dof, i) += component_amplitudes_[c] * mag * sin(phase - phase_shift);
+                }
+            }
+        }
+    }
+    double energy = component_amplitudes_.square().sum();
+    if (outside_energy > 1e-3 * energy) {
+        std::cerr << "Warning: " << 100.0 * outside_energy / energy << "% of the wave energy is outside of the h5 "
+                  << "frequencies [" << h5_omega_min << ", " << h5_omega_max << "] rad/s and has no excitation."
+                  << std::endl;
     }
+    force_.setZero(total_dofs);
 }
 
 // TODO put spectrum functions in a new namespace (when we have more options?)
@@ -664,19 +1295,38 @@ void IrregularWaves::CreateFreeSurfaceElevation() {
     double t_irf_min = 0.0;
     double t_irf_max = 0.0;
     for (auto ii = 0; ii < ex_irf_time_sampled_.size(); ii++) {
-        if (ex_irf_time_sampled_[ii][0] < t_irf_min) {
-            t_irf_min = ex_irf_time_sampled_[ii][0];
+        const auto& irf_time = *ex_irf_time_sampled_[ii];
+        if (irf_time[0] < t_irf_min) {
+            t_irf_min = irf_time[0];
         }
-        if (ex_irf_time_sampled_[ii][0] > t_irf_max) {
-            t_irf_max = ex_irf_time_sampled_[ii][0];
+        if (irf_time[0] > t_irf_max) {
+            t_irf_max = irf_time[0];
         }
-        if (ex_irf_time_sampled_[ii][ex_irf_time_sampled_[ii].size() - 1] > t_irf_max) {
-            t_irf_max = ex_irf_time_sampled_[ii][ex_irf_time_sampled_[ii].size() - 1];
+        if (irf_time[irf_time.size() - 1] > t_irf_max) {
+            t_irf_max = irf_time[irf_time.size() - 1];
         }
-        if (ex_irf_time_sampled_[ii][ex_irf_time_sampled_[ii].size() - 1] < t_irf_min) {
-            t_irf_min = ex_irf_time_sampled_[ii][ex_irf_time_sampled_[ii].size() - 1];
+        if (irf_time[irf_time.size() - 1] < t_irf_min) {
+            t_irf_min = irf_time[irf_time.size() - 1];
         }
     }
+    irf_time_min_ = t_irf_min;
+    irf_time_max_ = t_irf_max;
+    // start of the series and of the ramp, the convolution at t = 0 needs the elevation back to -t_irf_max
+    eta_time_origin_ = -t_irf_max;
+
+    if (params_.streaming_free_surface_) {
+        // same start and ramp as the precomputed series, generated during the simulation
+        eta_dt_             = params_.simulation_dt_;
+        window_first_index_ = 0;
+        free_surface_time_sampled_.clear();
+        free_surface_elevation_sampled_.clear();
+        body_free_surface_elevation_sampled_.assign(params_.eta_reference_positions_.size(), {});
+        std::cout << "Streaming free surface elevation in blocks of " +
+                         std::to_string(params_.streaming_block_duration_) + " s."
+                  << std::endl;
+        AdvanceFreeSurfaceWindow(0.0);
+        return;
+    }
 
     auto time_array =
         Eigen::VectorXd::LinSpaced(num_timesteps, 0, params_.simulation_duration_ + 2 * (t_irf_max - t_irf_min));
@@ -685,7 +1335,7 @@ void IrregularWaves::CreateFreeSurfaceElevation() {
     free_surface_time_sampled_.resize(time_array.size());
     Eigen::VectorXd::Map(&free_surface_time_sampled_[0], time_array.size()) = time_array;
     for (int ii = 0; ii < free_surface_time_sampled_.size(); ii++) {
-        free_surface_time_sampled_[ii] += -t_irf_max;
+        free_surface_time_sampled_[ii] += eta_time_origin_;
     }
 
     std::cout << "Precalculating free surface elevation from " + std::to_string(free_surface_time_sampled_.front()) +
@@ -694,45 +1344,192 @@ void IrregularWaves::CreateFreeSurfaceElevation() {
 
     // Calculate the free surface elevation
     // position assumed at (0.0, 0.0, 0.0)
-    auto position = Eigen::Vector3d(0.0, 0.0, 0.0);
-    // get timeseries
-    free_surface_elevation_sampled_ = GetEtaIrregularTimeSeries(
-        position, free_surface_time_sampled_, spectrum_frequencies_, spectral_densities_, spectral_widths_, wave_phases_, wavenumbers_);
+    free_surface_elevation_sampled_ = SynthesizeEta(Eigen::Vector3d(0.0, 0.0, 0.0), free_surface_time_sampled_);
+    ApplyRamp(free_surface_time_sampled_, free_surface_elevation_sampled_);
+
+    // one series per body, on the same time grid
+    body_free_surface_elevation_sampled_.clear();
+    for (const auto& position : params_.eta_reference_positions_) {
+        body_free_surface_elevation_sampled_.push_back(SynthesizeEta(position, free_surface_time_sampled_));
+        ApplyRamp(free_surface_time_sampled_, body_free_surface_elevation_sampled_.back());
+    }
 
-    // Apply ramp if ramp_duration is greater than 0
-    if (params_.ramp_duration_ > 0.0) {
-        // UpdateRampTimesteps();
-        int ramp_timesteps   = static_cast<int>(params_.ramp_duration_ / params_.simulation_dt_) + 1;
-        Eigen::VectorXd ramp = Eigen::VectorXd::LinSpaced(ramp_timesteps, 0.0, 1.0);
+    if (params_.diagnostics_ != nullptr) {
+        params_.diagnostics_->WriteSeries("eta", free_surface_time_sampled_, free_surface_elevation_sampled_);
+    }
 
-        for (size_t i = 0; i < ramp.size(); ++i) {
-            free_surface_elevation_sampled_[i] *= ramp[i];
+    std::cout << "Finished precalculating free surface elevation." << std::endl;
+}
+
+std::vector<double> IrregularWaves::SynthesizeEta(const Eigen::Vector3d& position,
+                                                  const std::vector<double>& times) const {
+    // the time array is uniform, the spectrum frequencies are uniform (CreateSpectrum)
+    double t0 = times.front();
+    double dt = times.size() > 1 ? (times.back() - t0) / (times.size() - 1) : 0.0;
+
+    // the phase shift k.x of the position is applied to each component, the directions of each frequency sum to one
+    // complex amplitude at a fixed position
+    Eigen::VectorXcd amplitudes = GetFrequencyAmplitudes(position);
+    std::vector<double> eta;
+    if (params_.fft_free_surface_) {
+        eta = GetEtaTimeSeriesChirpZ(t0, dt, times.size(), spectrum_frequencies_, amplitudes);
+    } else {
+        // direct sum of Re(a_i exp(i omega_i t)) over the frequencies at each time
+        Eigen::ArrayXd amplitudes_re = amplitudes.real().array();
+        Eigen::ArrayXd amplitudes_im = amplitudes.imag().array();
+        eta.resize(times.size());
+        hydroc::ParallelFor(eta.size(), params_.num_threads_, [&](size_t begin, size_t end) {
+            Eigen::ArrayXd sin_buffer, cos_buffer;
+            for (size_t n = begin; n < end; n++) {
+                hydroc::SinCos(spectrum_omegas_ * times[n], sin_buffer, cos_buffer);
+                eta[n] = (amplitudes_re * cos_buffer - amplitudes_im * sin_buffer).sum();
+            }
+        });
+    }
+    return eta;
+}
+
+void IrregularWaves::ApplyRamp(const std::vector<double>& times, std::vector<double>& eta) const {
+    // Apply ramp if ramp_duration is greater than 0, linear in time from the start of the series, so the precomputed
+    // and streamed series (different time steps) are ramped alike
+    if (params_.ramp_duration_ <= 0.0) {
+        return;
+    }
+    for (size_t i = 0; i < eta.size(); ++i) {
+        double elapsed = times[i] - eta_time_origin_;
+        if (elapsed >= params_.ramp_duration_) {
+            break;
         }
+        eta[i] *= std::max(elapsed, 0.0) / params_.ramp_duration_;
     }
+}
 
-    // Open a file stream for writing
-    std::ofstream eta_output("eta.txt");
+void IrregularWaves::AdvanceFreeSurfaceWindow(double time) {
+    size_t block_size = std::max<size_t>(2, std::ceil(params_.streaming_block_duration_ / eta_dt_));
 
-    // Check if the file stream is open
-    if (eta_output.is_open()) {
-        // Write the spectral densities and their corresponding frequencies to the file
-        for (size_t i = 0; i < free_surface_elevation_sampled_.size(); ++i) {
-            eta_output << free_surface_time_sampled_[i] << " : " << free_surface_elevation_sampled_[i] << std::endl;
+    // the convolution at time needs the elevation from time - irf_time_max_ to time - irf_time_min_
+    while (free_surface_time_sampled_.empty() || free_surface_time_sampled_.back() < time - irf_time_min_) {
+        size_t first_index = window_first_index_ + free_surface_time_sampled_.size();
+        std::vector<double> times(block_size);
+        for (size_t n = 0; n < block_size; n++) {
+            times[n] = eta_time_origin_ + (first_index + n) * eta_dt_;
         }
-        // Close the file stream
-        eta_output.close();
-    } else {
-        std::cerr << "Unable to open file for writing." << std::endl;
+
+        auto append_block = [&](std::vector<double>& eta_sampled, const Eigen::Vector3d& position) {
+            std::vector<double> eta = SynthesizeEta(position, times);
+            ApplyRamp(times, eta);
+            eta_sampled.insert(eta_sampled.end(), eta.begin(), eta.end());
+        };
+        append_block(free_surface_elevation_sampled_, Eigen::Vector3d(0.0, 0.0, 0.0));
+        for (size_t b = 0; b < body_free_surface_elevation_sampled_.size(); b++) {
+            append_block(body_free_surface_elevation_sampled_[b], params_.eta_reference_positions_[b]);
+        }
+        free_surface_time_sampled_.insert(free_surface_time_sampled_.end(), times.begin(), times.end());
     }
 
-    std::cout << "Finished precalculating free surface elevation." << std::endl;
+    // drop whole blocks older than the IRF support, keeping one block for calls at earlier times
+    double oldest_needed = time - irf_time_max_ - block_size * eta_dt_;
+    size_t num_old       = 0;
+    while (num_old + block_size < free_surface_time_sampled_.size() &&
+           free_surface_time_sampled_[num_old + block_size - 1] < oldest_needed) {
+        num_old += block_size;
+    }
+    if (num_old > 0) {
+        free_surface_time_sampled_.erase(free_surface_time_sampled_.begin(),
+                                         free_surface_time_sampled_.begin() + num_old);
+        free_surface_elevation_sampled_.erase(free_surface_elevation_sampled_.begin(),
+                                              free_surface_elevation_sampled_.begin() + num_old);
+        for (auto& eta_sampled : body_free_surface_elevation_sampled_) {
+            eta_sampled.erase(eta_sampled.begin(), eta_sampled.begin() + num_old);
+        }
+        window_first_index_ += num_old;
+    }
+}
+
+void IrregularWaves::PrecomputeExcitationForce() {
+    // imported elevations are on the time_data_ of the file
+    const auto& eta_times = spectrumCreated_ ? free_surface_time_sampled_ : time_data_;
+    if (eta_times.size() < 2) {
+        throw std::runtime_error("Excitation force: no free surface elevation to precompute the force from.");
+    }
+
+    std::cout << "Precalculating excitation force." << std::endl;
+    force_series_.resize(params_.num_bodies_);
+    force_series_start_.resize(params_.num_bodies_);
+    force_series_dt_.resize(params_.num_bodies_);
+    Eigen::FFT<double> fft;
+    for (unsigned int b = 0; b < params_.num_bodies_; b++) {
+        const auto& irf_time = *ex_irf_time_sampled_[b];
+        const auto& eta      = body_free_surface_elevation_sampled_.empty() ? free_surface_elevation_sampled_
+                                                                            : body_free_surface_elevation_sampled_[b];
+        Eigen::Index num_irf = irf_time.size();
+        double dtau          = (irf_time[num_irf - 1] - irf_time[0]) / (num_irf - 1);
+        for (Eigen::Index j = 0; j < num_irf; j++) {
+            if (std::abs(irf_time[j] - (irf_time[0] + j * dtau)) > 1e-6 * dtau) {
+                throw std::runtime_error(
+                    "Excitation force: precomputing the force needs a uniformly sampled excitation IRF (set "
+                    "simulation_dt_ to resample it).");
+            }
+        }
+
+        // force at t_n = eta_times.front() + irf_time[last] + n dtau, as long as t_n - irf_time[0] is in the
+        // elevation, needs the elevation at s_m = eta_times.front() + m dtau
+        double start = eta_times.front() + irf_time[num_irf - 1];
+        double span  = eta_times.back() + irf_time[0] - start;
+        if (span < 0.0) {
+            throw std::runtime_error("Excitation force: free surface elevation shorter than the excitation IRF.");
+        }
+        Eigen::Index num_force = static_cast<Eigen::Index>(span / dtau + 1e-9) + 1;
+        Eigen::Index num_eta   = num_force + num_irf - 1;
+
+        // elevation on the IRF time step, linearly interpolated
+        size_t fft_size = 1;
+        while (fft_size < static_cast<size_t>(num_eta)) {
+            fft_size *= 2;
+        }
+        std::vector<double> eta_resampled(fft_size, 0.0);
+        size_t idx = 0;
+        for (Eigen::Index m = 0; m < num_eta; m++) {
+            double s = std::min(eta_times.front() + m * dtau, eta_times.back());
+            while (idx + 2 < eta_times.size() && eta_times[idx + 1] < s) {
+                idx++;
+            }
+            double w2        = (s - eta_times[idx]) / (eta_times[idx + 1] - eta_times[idx]);
+            eta_resampled[m] = (1.0 - w2) * eta[idx] + w2 * eta[idx + 1];
+        }
+        std::vector<std::complex<double>> eta_spectrum;
+        fft.fwd(eta_spectrum, eta_resampled);
+
+        // F_n = sum_j (irf_j width_j) eta_{n + num_irf - 1 - j}, the linear convolution shifted by num_irf - 1
+        // (the circular wrap-around only reaches the first num_irf - 1 values)
+        auto& series = force_series_[b];
+        series.resize(6, num_force);
+        std::vector<double> irf_padded(fft_size), convolution;
+        std::vector<std::complex<double>> irf_spectrum;
+        for (int dof = 0; dof < 6; dof++) {
+            std::fill(irf_padded.begin(), irf_padded.end(), 0.0);
+            for (Eigen::Index j = 0; j < num_irf; j++) {
+                irf_padded[j] = (*ex_irf_weighted_[b])(dof, j);
+            }
+            fft.fwd(irf_spectrum, irf_padded);
+            for (size_t k = 0; k < fft_size; k++) {
+                irf_spectrum[k] *= eta_spectrum[k];
+            }
+            fft.inv(convolution, irf_spectrum);
+            for (Eigen::Index n = 0; n < num_force; n++) {
+                series(dof, n) = convolution[n + num_irf - 1];
+            }
+        }
+        force_series_start_[b] = start;
+        force_series_dt_[b]    = dtau;
+    }
+    std::cout << "Finished precalculating excitation force." << std::endl;
 }
 
-double IrregularWaves::ExcitationConvolution(int body, int dof, double time) {
-    double f_ex           = 0.0;
-    auto& irf_time_array  = ex_irf_time_sampled_[body];
-    auto& irf_val_mat     = ex_irf_sampled_[body];
-    auto& irf_width_array = ex_irf_width_sampled_[body];
+Eigen::Matrix<double, 6, 1> IrregularWaves::ExcitationConvolution(int body, double time) {
+    auto& irf_time_array = *ex_irf_time_sampled_[body];
+    auto& eta_sampled    = body_free_surface_elevation_sampled_.empty() ? free_surface_elevation_sampled_
+                                                                        : body_free_surface_elevation_sampled_[body];
 
     // asumptions: irf_time_array in ascending order, free_surface_time_sampled_ in ascending order
     // get initial index
@@ -749,6 +1546,7 @@ double IrregularWaves::ExcitationConvolution(int body, int dof, double time) {
     }
 
     // loop for all irf time values
+    convolution_eta_buffer_.resize(irf_time_array.size());
     for (size_t j = 0; j < irf_time_array.size(); ++j) {
         double tau   = irf_time_array[j];
         double t_tau = time - tau;
@@ -765,13 +1563,13 @@ double IrregularWaves::ExcitationConvolution(int body, int dof, double time) {
             // get free surface elevation
             double eta_val;
             if (t_tau == t1) {
-                eta_val = free_surface_time_sampled_[idx];
+                eta_val = eta_sampled[idx];
             } else if (t_tau == t2) {
-                eta_val = free_surface_time_sampled_[idx + 1];
+                eta_val = eta_sampled[idx + 1];
             } else if (t_tau > t1 && t_tau < t2) {
                 // linearly interpolate free surface elevation between bounds
-                auto eta1 = free_surface_elevation_sampled_[idx];
-                auto eta2 = free_surface_elevation_sampled_[idx + 1];
+                auto eta1 = eta_sampled[idx];
+                auto eta2 = eta_sampled[idx + 1];
                 // weights
                 auto w1 = (t2 - t_tau) / (t2 - t1);
                 auto w2 = 1.0 - w1;
@@ -782,8 +1580,7 @@ double IrregularWaves::ExcitationConvolution(int body, int dof, double time) {
                                          " not between " + std::to_string(t1) + " and " + std::to_string(t2) + ".");
             }
 
-            // add to excitation force
-            f_ex += irf_val_mat(dof, j) * eta_val * irf_width_array[j];
+            convolution_eta_buffer_[j] = eta_val;
 
         } else {
             // throw error if trying to compute convolution after the maximum precomputed free elevation time
@@ -795,7 +1592,8 @@ double IrregularWaves::ExcitationConvolution(int body, int dof, double time) {
         }
     }
 
-    return f_ex;
+    // add to excitation force
+    return *ex_irf_weighted_[body] * convolution_eta_buffer_;
 }
 
 void IrregularWaves::SetUpWaveMesh(std::string filename) {
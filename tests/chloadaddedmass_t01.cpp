@@ -41,13 +41,10 @@ int main(int argc, char* argv[]) {
         chrono_types::make_shared<chrono::ChBodyEasyMesh>(b2Meshfname,  // file name
                                                           density, evaluate_mass, create_visu_mesh, detect_collision);
 
-    HydroData infos = H5FileInfo(h5fname, 2).ReadH5Data();
+    auto infos = std::make_shared<const HydroData>(H5FileInfo(h5fname, 2).ReadH5Data());
 
     std::shared_ptr<ChLoadAddedMass> my_loadbodyinertia;
 
-    /// TODO Check if local vector is really copied into constructor of ChLoadAddedMass
-    /// else it could be a memory fault
-
     const size_t nBodies = 2;
     std::vector<std::shared_ptr<ChLoadable>> loadables;
     loadables.push_back(body1);
@@ -55,7 +52,7 @@ int main(int argc, char* argv[]) {
 
     ChSystemSMC my_system;
 
-    my_loadbodyinertia = chrono_types::make_shared<ChLoadAddedMass>(infos.GetBodyInfos(), loadables, &my_system);
+    my_loadbodyinertia = chrono_types::make_shared<ChLoadAddedMass>(infos, loadables, &my_system);
 
     std::cout << "End" << std::endl;
     return 0;
@@ -0,0 +1,122 @@
+#include <hydroc/diagnostics.h>
+#include <hydroc/h5fileinfo.h>
+#include <hydroc/helper.h>
+#include <hydroc/wave_types.h>
+
+#include <filesystem>  // C++17
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+using std::filesystem::path;
+
+// counts the series and records the thread of the last Flush()
+class RecordingSink : public DiagnosticsSink {
+  public:
+    void WriteSeries(const std::string&, const std::vector<double>&, const std::vector<double>&) override {
+        num_series++;
+    }
+    void Flush() override {
+        flush_thread    = std::this_thread::get_id();
+        series_at_flush = num_series;
+    }
+    int num_series      = 0;
+    int series_at_flush = -1;
+    std::thread::id flush_thread;
+};
+
+int main(int argc, char* argv[]) {
+    if (hydroc::SetInitialEnvironment(argc, argv) != 0) {
+        return 1;
+    }
+
+    path DATADIR(hydroc::getDataDir());
+    auto h5fname    = (DATADIR / "sphere" / "hydroData" / "sphere.h5").lexically_normal().generic_string();
+    auto hydro_data = std::make_shared<const HydroData>(H5FileInfo(h5fname, 1).ReadH5Data());
+
+    auto output_dir = std::filesystem::temp_directory_path() / "diagnostics_t01";
+    std::filesystem::remove_all(output_dir);
+
+    IrregularWaveParams params;
+    params.num_bodies_          = 1;
+    params.simulation_dt_       = 0.01;
+    params.simulation_duration_ = 100.0;
+    params.wave_height_         = 2.0;
+    params.wave_period_         = 8.0;
+
+    bool ok = true;
+
+    // per-run text directory, written by a background thread: eta.txt reads back as the precomputed elevation
+    auto run_dir        = output_dir / "run_1";
+    auto text_sink      = std::make_shared<TextDiagnosticsSink>(run_dir.string());
+    auto async_sink     = std::make_shared<AsyncDiagnosticsSink>(text_sink);
+    params.diagnostics_ = async_sink;
+    IrregularWaves wave(params);
+    wave.AddH5Data(hydro_data);
+    async_sink->Flush();
+    std::vector<double> eta_time, eta;
+    ReadEtaFile((run_dir / "eta.txt").string(), eta_time, eta);
+    if (eta_time != wave.GetFreeSurfaceTime() || eta != wave.GetFreeSurfaceElevation() ||
+        !std::filesystem::exists(run_dir / "spectral_densities.txt")) {
+        std::cerr << "Text diagnostics do not match the wave" << std::endl;
+        ok = false;
+    }
+
+    // the sink is flushed on the background thread, after the series written before
+    auto recording_sink = std::make_shared<RecordingSink>();
+    {
+        AsyncDiagnosticsSink recording_async_sink(recording_sink);
+        for (int i = 0; i < 3; i++) {
+            recording_async_sink.WriteSeries("series", {0.0}, {1.0});
+        }
+        recording_async_sink.Flush();
+    }
+    if (recording_sink->series_at_flush != 3 || recording_sink->flush_thread == std::this_thread::get_id()) {
+        std::cerr << "Asynchronous diagnostics are not flushed on the background thread after the written series"
+                  << std::endl;
+        ok = false;
+    }
+
+    // HDF5 group, two runs in the same file, the groups of the second run created with its series, the first run
+    // written again replaces its series
+    auto h5_output = (output_dir / "diagnostics.h5").string();
+    std::stringstream h5_errors;
+    auto cerr_buffer = std::cerr.rdbuf(h5_errors.rdbuf());
+    for (const char* group : {"run_1/waves", "/run_2/waves/", "run_1/waves"}) {
+        params.diagnostics_ = std::make_shared<HDF5DiagnosticsSink>(h5_output, group);
+        IrregularWaves h5_wave(params);
+        h5_wave.AddH5Data(hydro_data);
+    }
+    std::cerr.rdbuf(cerr_buffer);
+    if (!h5_errors.str().empty()) {
+        std::cerr << "HDF5 diagnostics errors: " << h5_errors.str() << std::endl;
+        ok = false;
+    }
+    if (!std::filesystem::exists(h5_output) ||
+        std::filesystem::file_size(h5_output) < 2 * eta.size() * 2 * sizeof(double)) {
+        std::cerr << "HDF5 diagnostics were not written" << std::endl;
+        ok = false;
+    }
+
+    // turned off: nothing written
+    params.diagnostics_ = std::make_shared<NullDiagnosticsSink>();
+    auto empty_dir      = output_dir / "run_3";
+    std::filesystem::create_directories(empty_dir);
+    auto working_dir = std::filesystem::current_path();
+    std::filesystem::current_path(empty_dir);
+    {
+        IrregularWaves quiet_wave(params);
+        quiet_wave.AddH5Data(hydro_data);
+    }
+    std::filesystem::current_path(working_dir);
+    if (!std::filesystem::is_empty(empty_dir)) {
+        std::cerr << "Diagnostics written while turned off" << std::endl;
+        ok = false;
+    }
+
+    std::filesystem::remove_all(output_dir);
+
+    std::cout << "End" << std::endl;
+    return ok ? 0 : 1;
+}
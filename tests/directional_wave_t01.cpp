@@ -0,0 +1,164 @@
+#include <hydroc/h5fileinfo.h>
+#include <hydroc/helper.h>
+#include <hydroc/wave_types.h>
+
+#include <cmath>
+#include <filesystem>  // C++17
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+
+using std::filesystem::path;
+
+int main(int argc, char* argv[]) {
+    if (hydroc::SetInitialEnvironment(argc, argv) != 0) {
+        return 1;
+    }
+
+    path DATADIR(hydroc::getDataDir());
+
+    auto h5fname = (DATADIR / "sphere" / "hydroData" / "sphere.h5").lexically_normal().generic_string();
+
+    auto hydro_data = std::make_shared<const HydroData>(H5FileInfo(h5fname, 1).ReadH5Data());
+
+    IrregularWaveParams params;
+    params.num_bodies_          = 1;
+    params.simulation_dt_       = 0.01;
+    params.simulation_duration_ = 200.0;
+    params.wave_height_         = 2.0;
+    params.wave_period_         = 8.0;
+
+    bool ok = true;
+
+    // a spreading table with a single direction along +x is the long-crested sea, with its excitation synthesized
+    // from the h5 excitation coefficients instead of the IRF convolution
+    IrregularWaves long_crested(params);
+    long_crested.AddH5Data(hydro_data);
+    params.spreading_directions_ = {0.0};
+    params.spreading_weights_    = {1.0};
+    IrregularWaves table_wave(params);
+    table_wave.AddH5Data(hydro_data);
+
+    Eigen::VectorXd force_error = Eigen::VectorXd::Zero(6), force_max = Eigen::VectorXd::Zero(6);
+    for (int n = 0; n < 20000; n++) {
+        double t            = n * 0.01;
+        Eigen::VectorXd irf = long_crested.GetForceAtTime(t);
+        Eigen::VectorXd fd  = table_wave.GetForceAtTime(t);
+        force_error         = force_error.cwiseMax((irf - fd).cwiseAbs());
+        force_max           = force_max.cwiseMax(irf.cwiseAbs());
+    }
+    for (int dof : {0, 2, 4}) {
+        if (force_error[dof] > 0.03 * force_max[dof]) {
+            std::cerr << "Synthesized excitation of dof " << dof << " differs from the IRF convolution by "
+                      << force_error[dof] << " (max " << force_max[dof] << ")" << std::endl;
+            ok = false;
+        }
+    }
+    Eigen::Vector3d point(3.0, 2.0, -4.0);
+    if (long_crested.GetVelocity(point, 7.0) != table_wave.GetVelocity(point, 7.0) ||
+        long_crested.GetFreeSurfaceElevation() != table_wave.GetFreeSurfaceElevation()) {
+        std::cerr << "Single direction spreading table changes the kinematics" << std::endl;
+        ok = false;
+    }
+
+    // frequency domain excitation of the long-crested sea: same synthesis as the single direction table, without
+    // IRF convolution or precomputed elevation
+    params.spreading_directions_.clear();
+    params.spreading_weights_.clear();
+    params.frequency_domain_excitation_ = true;
+    IrregularWaves frequency_domain(params);
+    frequency_domain.AddH5Data(hydro_data);
+    params.frequency_domain_excitation_ = false;
+    double synthesis_error              = 0.0;
+    for (double t : {0.0, 13.7, 150.2}) {
+        synthesis_error =
+            std::max(synthesis_error, (frequency_domain.GetForceAtTime(t) - table_wave.GetForceAtTime(t)).norm());
+    }
+    if (synthesis_error > 1e-9 * force_max.norm() || !frequency_domain.GetFreeSurfaceElevation().empty()) {
+        std::cerr << "Frequency domain excitation of the long-crested sea differs from the synthesis by "
+                  << synthesis_error << std::endl;
+        ok = false;
+    }
+
+    // ramped frequency domain excitation: the force is ramped from t = 0, the convolution ramps the elevation from
+    // the start of its series, both reach the unramped force at the end of the ramp
+    params.ramp_duration_               = 40.0;
+    params.frequency_domain_excitation_ = true;
+    IrregularWaves ramped_frequency_domain(params);
+    ramped_frequency_domain.AddH5Data(hydro_data);
+    params.frequency_domain_excitation_ = false;
+    IrregularWaves ramped_convolution(params);
+    ramped_convolution.AddH5Data(hydro_data);
+    params.ramp_duration_ = 0.0;
+    double ramp_error = 0.0, ramped_error = 0.0, ramped_max = 0.0;
+    for (int n = 0; n < 8000; n++) {
+        double t           = n * 0.01;
+        Eigen::VectorXd fd = ramped_frequency_domain.GetForceAtTime(t);
+        if (t < 40.0) {
+            ramp_error = std::max(ramp_error, (fd - t / 40.0 * frequency_domain.GetForceAtTime(t)).norm());
+        } else {
+            Eigen::VectorXd irf = ramped_convolution.GetForceAtTime(t);
+            ramped_error        = std::max(ramped_error, std::abs(fd[2] - irf[2]));
+            ramped_max          = std::max(ramped_max, std::abs(irf[2]));
+        }
+    }
+    if (ramp_error > 1e-9 * force_max.norm() || ramped_error > 0.03 * ramped_max) {
+        std::cerr << "Ramped frequency domain excitation: ramp error " << ramp_error
+                  << ", difference to the IRF convolution after the ramp " << ramped_error << " (max " << ramped_max
+                  << ")" << std::endl;
+        ok = false;
+    }
+
+    // a spectrum above the h5 frequencies (12 rad/s) has no excitation, not the excitation of the highest frequency
+    IrregularWaveParams high_params          = params;
+    high_params.frequency_min_               = 2.0;
+    high_params.frequency_max_               = 3.0;
+    high_params.frequency_domain_excitation_ = true;
+    IrregularWaves high_frequency(high_params);
+    high_frequency.AddH5Data(hydro_data);
+    if (high_frequency.GetForceAtTime(13.7).norm() != 0.0) {
+        std::cerr << "Spectrum outside of the h5 frequencies has an excitation" << std::endl;
+        ok = false;
+    }
+
+    // two directions per frequency with independent phases: the precomputed series sums the directions of each
+    // frequency, it has to match the elevation of the components
+    params.spreading_directions_ = {0.0, 0.0};
+    params.spreading_weights_    = {1.0, 3.0};
+    IrregularWaves two_directions(params);
+    two_directions.AddH5Data(hydro_data);
+    auto eta  = two_directions.GetFreeSurfaceElevation();
+    auto time = two_directions.GetFreeSurfaceTime();
+
+    double eta_error = 0.0, eta_max = 0.0;
+    for (size_t n = 0; n < time.size(); n += 53) {
+        double direct = two_directions.GetElevation(Eigen::Vector3d::Zero(), time[n]);
+        eta_error     = std::max(eta_error, std::abs(eta[n] - direct));
+        eta_max       = std::max(eta_max, std::abs(direct));
+    }
+    if (eta_error > 1e-9 * eta_max) {
+        std::cerr << "Directional free surface elevation differs from the sum of components by " << eta_error
+                  << std::endl;
+        ok = false;
+    }
+
+    // the sphere h5 file only has one heading, a spread sea needs the excitation of other headings
+    params.spreading_directions_.clear();
+    params.spreading_weights_.clear();
+    params.num_directions_ = 9;
+    params.spreading_s_    = 4.0;
+    bool thrown            = false;
+    try {
+        IrregularWaves spread(params);
+        spread.AddH5Data(hydro_data);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    if (!thrown) {
+        std::cerr << "Spread sea outside of the h5 headings was accepted" << std::endl;
+        ok = false;
+    }
+
+    std::cout << "End" << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,76 @@
+#include <hydroc/dispersion.h>
+#include <hydroc/helper.h>
+
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+int main(int argc, char* argv[]) {
+    if (hydroc::SetInitialEnvironment(argc, argv) != 0) {
+        return 1;
+    }
+
+    const double g = 9.81;
+    bool ok        = true;
+
+    // residual of the dispersion relation from very shallow to deep water, batch and single frequency solves agree
+    Eigen::VectorXd omegas = Eigen::VectorXd::LinSpaced(2000, 0.0, 12.0);
+    for (double depth : {0.5, 5.0, 30.0, 200.0, 5000.0}) {
+        DispersionSolver solver(depth, g);
+        Eigen::VectorXd wavenumbers = solver.GetWaveNumbers(omegas);
+        double residual = 0.0, single_error = 0.0;
+        for (Eigen::Index i = 0; i < omegas.size(); i += 7) {
+            double k     = wavenumbers[i];
+            double omega = omegas[i];
+            residual     = std::max(residual, std::abs(g * k * std::tanh(k * depth) - omega * omega) /
+                                                  std::max(omega * omega, 1e-300));
+            single_error = std::max(single_error, std::abs(DispersionSolver(depth, g).GetWaveNumber(omega) - k));
+        }
+        if (wavenumbers[0] != 0.0 || residual > 1e-13 || single_error > 1e-12 * wavenumbers.maxCoeff()) {
+            std::cerr << "Dispersion relation at depth " << depth << ": residual " << residual
+                      << ", single frequency difference " << single_error << std::endl;
+            ok = false;
+        }
+    }
+
+    // shallow and deep water limits
+    double shallow_k = DispersionSolver(1.0, g).GetWaveNumber(0.01);
+    double deep_k    = DispersionSolver(1000.0, g).GetWaveNumber(5.0);
+    if (std::abs(shallow_k - 0.01 / std::sqrt(g)) > 1e-5 * shallow_k || std::abs(deep_k - 25.0 / g) > 1e-12 * deep_k) {
+        std::cerr << "Dispersion limits: " << shallow_k << " " << deep_k << std::endl;
+        ok = false;
+    }
+
+    // one shared solver per depth, repeated solves are table lookups with the same values
+    auto shared = DispersionSolver::Get(30.0, g);
+    if (shared != DispersionSolver::Get(30.0, g) || shared == DispersionSolver::Get(31.0, g) ||
+        shared->GetWaveNumbers(omegas) != shared->GetWaveNumbers(omegas) ||
+        shared->GetWaveNumber(omegas[5]) != shared->GetWaveNumbers(omegas)[5]) {
+        std::cerr << "Shared dispersion solver does not reuse its table" << std::endl;
+        ok = false;
+    }
+
+    // batches larger than the table, solved on several threads, give the values of a single threaded solve
+    Eigen::VectorXd sweep             = Eigen::VectorXd::LinSpaced(20000, 0.01, 20.0);
+    Eigen::VectorXd sweep_wavenumbers = DispersionSolver(30.0, g).GetWaveNumbers(sweep);
+    if (shared->GetWaveNumbers(sweep, 4) != sweep_wavenumbers ||
+        shared->GetWaveNumbers(sweep, 3) != sweep_wavenumbers ||
+        shared->GetWaveNumbers(omegas) != DispersionSolver(30.0, g).GetWaveNumbers(omegas)) {
+        std::cerr << "Threaded dispersion solve of a large batch differs from the single threaded solve" << std::endl;
+        ok = false;
+    }
+
+    bool thrown = false;
+    try {
+        DispersionSolver(0.0, g);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    if (!thrown) {
+        std::cerr << "Zero water depth was accepted" << std::endl;
+        ok = false;
+    }
+
+    std::cout << "End" << std::endl;
+    return ok ? 0 : 1;
+}
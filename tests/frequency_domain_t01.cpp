@@ -0,0 +1,109 @@
+#include <hydroc/frequency_domain.h>
+#include <hydroc/h5fileinfo.h>
+#include <hydroc/helper.h>
+
+#include <cmath>
+#include <filesystem>  // C++17
+#include <iostream>
+#include <memory>
+
+using std::filesystem::path;
+
+int main(int argc, char* argv[]) {
+    if (hydroc::SetInitialEnvironment(argc, argv) != 0) {
+        return 1;
+    }
+
+    path DATADIR(hydroc::getDataDir());
+
+    auto h5fname = (DATADIR / "sphere" / "hydroData" / "sphere.h5").lexically_normal().generic_string();
+
+    auto hydro_data = std::make_shared<const HydroData>(H5FileInfo(h5fname, 1).ReadH5Data());
+    if (!hydro_data->HasFrequencyDependentRadiation()) {
+        std::cerr << "No frequency dependent radiation data in " << h5fname << std::endl;
+        return 1;
+    }
+
+    // sphere in heave only with a linear damper, as in demo_sphere_reg_waves (wave #5)
+    const double mass        = 261.8e3;
+    const double pto_damping = 322292.419;
+    const double omega       = 1.047197551;
+
+    Eigen::MatrixXd mass_matrix = Eigen::MatrixXd::Zero(6, 6);
+    mass_matrix.diagonal() << mass, mass, mass, 1.0, 1.0, 1.0;
+    Eigen::MatrixXd damping = Eigen::MatrixXd::Zero(6, 6);
+    damping(2, 2)           = pto_damping;
+
+    FrequencyDomainSolver solver(hydro_data, mass_matrix);
+    solver.SetPTO(damping, Eigen::MatrixXd::Zero(6, 6));
+    solver.SetActiveDofs({2});
+
+    Eigen::VectorXd omegas(3);
+    omegas << 0.1, omega, 2.0;
+    auto results = solver.Solve(omegas);
+
+    bool ok = true;
+
+    // long waves: the sphere follows the free surface
+    double rao_low = std::abs(results.response(2, 0));
+    if (std::abs(rao_low - 1.0) > 0.05) {
+        std::cerr << "Heave RAO at omega 0.1 is " << rao_low << ", expected about 1" << std::endl;
+        ok = false;
+    }
+
+    // steady state heave amplitude of the time domain reference ref_sphere_reg_waves_5.txt (0.504 m for a 0.706 m wave)
+    double rao_ref = 0.504 / 0.706;
+    double rao     = std::abs(results.response(2, 1));
+    if (std::abs(rao - rao_ref) > 0.02 * rao_ref) {
+        std::cerr << "Heave RAO at omega " << omega << " is " << rao << ", expected " << rao_ref << std::endl;
+        ok = false;
+    }
+
+    // fixed dofs do not move, the damper absorbs power
+    if (results.response.row(0).norm() != 0.0 || results.response.row(4).norm() != 0.0) {
+        std::cerr << "Fixed dofs have a non zero response" << std::endl;
+        ok = false;
+    }
+    for (int k = 0; k < omegas.size(); k++) {
+        double power = 0.5 * pto_damping * std::pow(omegas[k] * std::abs(results.response(2, k)), 2);
+        if (!(results.pto_power[k] > 0.0) || std::abs(results.pto_power[k] - power) > 1e-9 * power) {
+            std::cerr << "PTO power at omega " << omegas[k] << " is " << results.pto_power[k] << ", expected " << power
+                      << std::endl;
+            ok = false;
+        }
+    }
+
+    // frequencies outside of the h5 data are rejected
+    bool thrown = false;
+    try {
+        Eigen::VectorXd outside(1);
+        outside << 100.0;
+        solver.Solve(outside);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    if (!thrown) {
+        std::cerr << "Solve() accepted a frequency outside of the h5 data" << std::endl;
+        ok = false;
+    }
+
+    // headings wrap by 360 degrees like RegularWave, the sphere h5 file only has the heading 0
+    if (solver.Solve(omegas, 360.0).response != results.response) {
+        std::cerr << "Response at the heading 360 differs from the heading 0" << std::endl;
+        ok = false;
+    }
+    thrown = false;
+    try {
+        solver.Solve(omegas, 90.0);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    if (!thrown) {
+        std::cerr << "Solve() accepted a heading outside of the h5 data" << std::endl;
+        ok = false;
+    }
+
+    std::cout << "Heave RAO: " << rao_low << " " << rao << " " << std::abs(results.response(2, 2)) << std::endl;
+    std::cout << "End" << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,73 @@
+#include <hydroc/h5fileinfo.h>
+#include <hydroc/helper.h>
+
+#include <cmath>
+#include <filesystem>  // C++17
+#include <iostream>
+
+using std::filesystem::path;
+
+// checks Lookup() against a linear search over the frequencies
+bool CheckTable(const FrequencyTable& table, const Eigen::VectorXd& omegas) {
+    bool ok       = true;
+    int num_freqs = omegas.size();
+    for (int k = 0; k < num_freqs - 1; k++) {
+        for (double fraction : {0.0, 0.25, 0.5, 0.999}) {
+            double omega = omegas[k] + fraction * (omegas[k + 1] - omegas[k]);
+            auto interp  = table.Lookup(omega);
+            double value = omegas[interp.index];
+            if (interp.weight > 0.0) {
+                value += interp.weight * (omegas[interp.index + 1] - omegas[interp.index]);
+            }
+            // interpolating the frequencies themselves gives omega back
+            if (interp.index != k || std::abs(value - omega) > 1e-12 * omega) {
+                std::cerr << "Lookup(" << omega << ") gives index " << interp.index << " weight " << interp.weight
+                          << ", expected index " << k << std::endl;
+                ok = false;
+            }
+        }
+    }
+    auto last = table.Lookup(omegas[num_freqs - 1]);
+    if (last.index != num_freqs - 1 || last.weight != 0.0) {
+        std::cerr << "Lookup of the last frequency gives index " << last.index << std::endl;
+        ok = false;
+    }
+    for (double omega : {omegas[0] * 0.5, omegas[num_freqs - 1] * 1.5}) {
+        bool thrown = false;
+        try {
+            table.Lookup(omega);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        if (!thrown) {
+            std::cerr << "Lookup(" << omega << ") outside of the table did not throw" << std::endl;
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    if (hydroc::SetInitialEnvironment(argc, argv) != 0) {
+        return 1;
+    }
+
+    path DATADIR(hydroc::getDataDir());
+
+    auto h5fname = (DATADIR / "sphere" / "hydroData" / "sphere.h5").lexically_normal().generic_string();
+
+    // uniform frequencies of the sphere
+    HydroData data   = H5FileInfo(h5fname, 1).ReadH5Data();
+    const auto& freq = data.GetRegularWaveInfos()[0].freq_list;
+    bool ok          = CheckTable(data.GetFrequencyTable(), freq);
+
+    // non-uniform frequencies, finer at low frequencies as written by some BEM codes
+    Eigen::VectorXd omegas(40);
+    for (int k = 0; k < omegas.size(); k++) {
+        omegas[k] = 0.1 + 0.02 * k + 0.004 * k * k;
+    }
+    ok = CheckTable(FrequencyTable(omegas), omegas) && ok;
+
+    std::cout << "End" << std::endl;
+    return ok ? 0 : 1;
+}
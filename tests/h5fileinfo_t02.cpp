@@ -0,0 +1,73 @@
+#include <hydroc/h5fileinfo.h>
+#include <hydroc/helper.h>
+
+#include <cstdlib>
+#include <filesystem>  // C++17
+#include <iostream>
+#include <vector>
+
+using std::filesystem::path;
+
+// loads a body and frequency subset of rm3.h5 (bodies in reverse order) and compares it to the full data
+int main(int argc, char* argv[]) {
+    if (hydroc::SetInitialEnvironment(argc, argv) != 0) {
+        return 1;
+    }
+
+    path DATADIR(hydroc::getDataDir());
+
+    auto h5fname = (DATADIR / "rm3" / "hydroData" / "rm3.h5").lexically_normal().generic_string();
+
+    HydroData full = H5FileInfo(h5fname, 2).ReadH5Data();
+
+    HydroDataSelection selection;
+    selection.body_indices = {1, 0};
+    selection.omega_min    = 0.5;
+    selection.omega_max    = 2.0;
+    HydroData subset       = H5FileInfo(h5fname, selection).ReadH5Data();
+
+    const auto& full_freqs = full.GetRegularWaveInfos()[0].freq_list;
+    int freq_start         = 0;
+    while (full_freqs[freq_start] < selection.omega_min) {
+        freq_start++;
+    }
+
+    bool ok = true;
+    for (int c = 0; c < 2; c++) {
+        int b                = selection.body_indices[c];
+        const auto& body     = subset.GetBodyInfos()[c];
+        const auto& ref_body = full.GetBodyInfos()[b];
+        ok                   = ok && body.body_num == b && subset.GetLinMatrix(c) == full.GetLinMatrix(b);
+
+        // coupling columns are re-indexed to the selected bodies
+        for (int cc = 0; cc < 2; cc++) {
+            int bb = selection.body_indices[cc];
+            ok     = ok && *body.inf_added_mass_blocks[cc] == *ref_body.inf_added_mass_blocks[bb];
+            Eigen::Tensor<double, 0> rirf_diff =
+                (*body.rirf_blocks[cc] - *ref_body.rirf_blocks[bb]).abs().maximum();
+            ok = ok && rirf_diff() == 0.0;
+        }
+
+        // frequency dependent data only within the selected range
+        const auto& reg     = subset.GetRegularWaveInfos()[c];
+        const auto& ref_reg = full.GetRegularWaveInfos()[b];
+        ok = ok && reg.freq_list.minCoeff() >= selection.omega_min && reg.freq_list.maxCoeff() <= selection.omega_max;
+        ok = ok && reg.freq_list.size() == reg.excitation_mag_matrix.dimension(2);
+        for (int k = 0; k < reg.freq_list.size(); k++) {
+            ok = ok && reg.freq_list[k] == full_freqs[freq_start + k];
+            for (int i = 0; i < 6; i++) {
+                ok = ok && reg.excitation_mag_matrix(i, 0, k) == ref_reg.excitation_mag_matrix(i, 0, freq_start + k);
+                ok = ok &&
+                     reg.excitation_phase_matrix(i, 0, k) == ref_reg.excitation_phase_matrix(i, 0, freq_start + k);
+            }
+        }
+    }
+
+    if (!ok) {
+        std::cout << "Subset of h5 data does not match the full data." << std::endl;
+        return 1;
+    }
+
+    std::cout << "End" << std::endl;
+    return 0;
+}
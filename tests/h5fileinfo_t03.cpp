@@ -0,0 +1,52 @@
+#include <hydroc/h5fileinfo.h>
+#include <hydroc/helper.h>
+
+#include <cstdlib>
+#include <filesystem>  // C++17
+#include <iostream>
+#include <vector>
+
+using std::filesystem::path;
+
+// loads the same rm3 body twice (as two identical devices) and checks their coefficients share storage
+int main(int argc, char* argv[]) {
+    if (hydroc::SetInitialEnvironment(argc, argv) != 0) {
+        return 1;
+    }
+
+    path DATADIR(hydroc::getDataDir());
+
+    auto h5fname = (DATADIR / "rm3" / "hydroData" / "rm3.h5").lexically_normal().generic_string();
+
+    HydroDataSelection selection;
+    selection.body_indices = {0, 0};
+    HydroData infos        = H5FileInfo(h5fname, selection).ReadH5Data();
+    infos.ResampleExcitationIRF(0.01);
+
+    const auto& body0  = infos.GetBodyInfos()[0];
+    const auto& body1  = infos.GetBodyInfos()[1];
+    const auto& irreg0 = infos.GetIrregularWaveInfos()[0];
+    const auto& irreg1 = infos.GetIrregularWaveInfos()[1];
+
+    bool ok = body0.lin_matrix == body1.lin_matrix && body0.rirf_blocks[0] == body1.rirf_blocks[1] &&
+              body0.rirf_blocks[0] == body0.rirf_blocks[1] &&
+              body0.inf_added_mass_blocks[0] == body1.inf_added_mass_blocks[1] &&
+              irreg0.excitation_irf_matrix == irreg1.excitation_irf_matrix &&
+              infos.GetResampledExcitationIRF(0, 0.01) == infos.GetResampledExcitationIRF(1, 0.01);
+
+    // everything identical is already shared
+    ok = ok && infos.ShareIdenticalCoefficients(1e-12) == 0;
+
+    // the shared blocks give the same values as a regular load
+    HydroData reference = H5FileInfo(h5fname, 1).ReadH5Data();
+    ok                  = ok && infos.GetLinMatrix(1) == reference.GetLinMatrix(0) &&
+         infos.GetRIRFVal(1, 2, 8, 10) == reference.GetRIRFVal(0, 2, 2, 10);
+
+    if (!ok) {
+        std::cout << "Identical bodies do not share their coefficients." << std::endl;
+        return 1;
+    }
+
+    std::cout << "End" << std::endl;
+    return 0;
+}
@@ -0,0 +1,156 @@
+#include <hydroc/h5fileinfo.h>
+#include <hydroc/helper.h>
+#include <hydroc/hydro_data_cache.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>  // C++17
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using std::filesystem::path;
+
+int main(int argc, char* argv[]) {
+    if (hydroc::SetInitialEnvironment(argc, argv) != 0) {
+        return 1;
+    }
+
+    path DATADIR(hydroc::getDataDir());
+
+    auto h5fname = (DATADIR / "sphere" / "hydroData" / "sphere.h5").lexically_normal().generic_string();
+
+    HydroDataPreprocessOptions options;
+    options.excitation_irf_dt = 0.015;
+
+    HydroDataCache cache("hydro_data_cache");
+    std::filesystem::remove(cache.GetCacheFilePath(h5fname, 1, options));
+
+    HydroData reference = H5FileInfo(h5fname, 1).ReadH5Data();
+    reference.ResampleExcitationIRF(options.excitation_irf_dt);
+
+    // first load writes the cache file, second load reads it back
+    HydroData written = cache.Load(h5fname, 1, options);
+    if (!std::filesystem::exists(cache.GetCacheFilePath(h5fname, 1, options))) {
+        std::cerr << "Cache file was not written" << std::endl;
+        return 1;
+    }
+    HydroData cached = cache.Load(h5fname, 1, options);
+
+    for (auto* infos : {&written, &cached}) {
+        auto& body     = infos->GetBodyInfos()[0];
+        auto& ref_body = reference.GetBodyInfos()[0];
+        Eigen::Tensor<double, 0> rirf_diff = (*body.rirf_blocks[0] - *ref_body.rirf_blocks[0]).abs().maximum();
+        Eigen::Tensor<double, 0> mag_diff  = (infos->GetRegularWaveInfos()[0].excitation_mag_matrix -
+                                             reference.GetRegularWaveInfos()[0].excitation_mag_matrix)
+                                                .abs()
+                                                .maximum();
+        auto irf     = infos->GetResampledExcitationIRF(0, options.excitation_irf_dt);
+        auto ref_irf = reference.GetResampledExcitationIRF(0, options.excitation_irf_dt);
+        if (rirf_diff() != 0.0 || mag_diff() != 0.0 ||
+            infos->GetInfAddedMassMatrix(0) != reference.GetInfAddedMassMatrix(0) ||
+            infos->GetLinMatrix(0) != reference.GetLinMatrix(0) || infos->GetRhoVal() != reference.GetRhoVal() ||
+            *irf->values != *ref_irf->values || *irf->time != *ref_irf->time || irf->widths != ref_irf->widths) {
+            std::cerr << "Cached hydro data differs from h5 file data" << std::endl;
+            return 1;
+        }
+    }
+
+    // resampled IRFs cached per time step: other time steps are resampled once, also when requested from several
+    // threads
+    std::vector<std::shared_ptr<const HydroData::ResampledExcitationIRF>> resampled(4);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < resampled.size(); i++) {
+        threads.emplace_back([&, i] { resampled[i] = cached.GetResampledExcitationIRF(0, 0.01); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    Eigen::VectorXd time_new;
+    Eigen::MatrixXd vals_new;
+    ResampleIRF(reference.GetIrregularWaveInfos()[0].excitation_irf_time,
+                *reference.GetIrregularWaveInfos()[0].excitation_irf_matrix, 0.01, time_new, vals_new);
+    Eigen::Index n       = time_new.size();
+    Eigen::VectorXd step = time_new.tail(n - 1) - time_new.head(n - 1);
+    if (resampled[1] != resampled[0] || resampled[3] != resampled[2] || resampled[2] != resampled[0] ||
+        *resampled[0]->values != vals_new || *resampled[0]->time != time_new ||
+        std::abs(resampled[0]->widths[0] - 0.5 * step[0]) > 1e-15 ||
+        std::abs(resampled[0]->widths[1] - 0.5 * (step[0] + step[1])) > 1e-15) {
+        std::cerr << "Resampled excitation IRF cache differs from the resampling" << std::endl;
+        return 1;
+    }
+
+    // a copy shares the resampled IRFs of the original until its IRF is modified: the resampled IRF of the modified
+    // IRF is not served to the original, and modifying it again clears the cached one
+    const HydroData& original = cached;
+    HydroData modified        = cached;
+    const auto& irreg         = original.GetIrregularWaveInfos()[0];
+    auto shared               = modified.GetResampledExcitationIRF(0, 0.01);
+    modified.SetExcitationIRF(0, irreg.excitation_irf_time,
+                              std::make_shared<const Eigen::MatrixXd>(2.0 * *irreg.excitation_irf_matrix));
+    auto doubled = modified.GetResampledExcitationIRF(0, 0.01);
+    modified.SetExcitationIRF(0, irreg.excitation_irf_time, irreg.excitation_irf_matrix);
+    if (shared != resampled[0] || doubled == resampled[0] || *doubled->values != 2.0 * vals_new ||
+        original.GetResampledExcitationIRF(0, 0.01) != resampled[0] ||
+        *modified.GetResampledExcitationIRF(0, 0.01)->values != vals_new) {
+        std::cerr << "Resampled excitation IRF cache is not cleared with the IRFs it was computed from" << std::endl;
+        return 1;
+    }
+
+    // subset selection and coefficient sharing are part of the key: the sphere loaded twice, on a frequency range
+    HydroDataPreprocessOptions subset_options = options;
+    subset_options.selection.body_indices     = {0, 0};
+    subset_options.selection.omega_min        = 0.5;
+    subset_options.selection.omega_max        = 3.0;
+    subset_options.share_tolerance            = 1e-12;
+    HydroData subset_reference                = H5FileInfo(h5fname, subset_options.selection).ReadH5Data();
+    std::filesystem::remove(cache.GetCacheFilePath(h5fname, 2, subset_options));
+    cache.Load(h5fname, 2, subset_options);
+    HydroData subset = cache.Load(h5fname, 2, subset_options);
+    HydroDataPreprocessOptions unshared_options = subset_options;
+    unshared_options.share_tolerance            = 0.0;
+    HydroDataPreprocessOptions full_range       = subset_options;
+    full_range.selection.omega_max              = std::numeric_limits<double>::infinity();
+    const auto& subset_irreg                    = subset.GetIrregularWaveInfos();
+    if (cache.GetCacheFilePath(h5fname, 2, subset_options) == cache.GetCacheFilePath(h5fname, 2, unshared_options) ||
+        cache.GetCacheFilePath(h5fname, 2, subset_options) == cache.GetCacheFilePath(h5fname, 2, full_range) ||
+        subset.GetRegularWaveInfos()[1].freq_list != subset_reference.GetRegularWaveInfos()[1].freq_list ||
+        subset.GetLinMatrix(1) != subset_reference.GetLinMatrix(1) ||
+        subset.GetBodyInfos()[0].lin_matrix != subset.GetBodyInfos()[1].lin_matrix ||
+        subset_irreg[0].excitation_irf_matrix != subset_irreg[1].excitation_irf_matrix ||
+        subset.GetResampledExcitationIRF(1, options.excitation_irf_dt) !=
+            subset.GetResampledExcitationIRF(0, options.excitation_irf_dt)) {
+        std::cerr << "Cached subset of the hydro data differs from the selection" << std::endl;
+        return 1;
+    }
+    bool thrown = false;
+    try {
+        cache.Load(h5fname, 1, subset_options);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    if (!thrown) {
+        std::cerr << "Selection of two bodies was accepted for one body" << std::endl;
+        return 1;
+    }
+
+    // the key follows the h5 file modification time, without reading the h5 file unless the content is hashed
+    auto h5_copy = (path("hydro_data_cache") / "sphere_copy.h5").generic_string();
+    std::filesystem::copy_file(h5fname, h5_copy, std::filesystem::copy_options::overwrite_existing);
+    std::string copy_cache_file = cache.GetCacheFilePath(h5_copy, 1, options);
+    std::filesystem::last_write_time(h5_copy, std::filesystem::last_write_time(h5_copy) + std::chrono::seconds(10));
+    HydroDataCache hashing_cache("hydro_data_cache", true);
+    if (cache.GetCacheFilePath(h5_copy, 1, options) == copy_cache_file ||
+        hashing_cache.GetCacheFilePath(h5_copy, 1, options) == cache.GetCacheFilePath(h5_copy, 1, options) ||
+        hashing_cache.Load(h5_copy, 1, options).GetLinMatrix(0) != reference.GetLinMatrix(0)) {
+        std::cerr << "Cache key does not follow the h5 file" << std::endl;
+        return 1;
+    }
+    std::filesystem::remove_all("hydro_data_cache");
+
+    std::cout << "End" << std::endl;
+    return 0;
+}
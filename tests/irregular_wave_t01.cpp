@@ -0,0 +1,348 @@
+#include <hydroc/h5fileinfo.h>
+#include <hydroc/helper.h>
+#include <hydroc/wave_types.h>
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>  // C++17
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+
+using std::filesystem::path;
+
+int main(int argc, char* argv[]) {
+    if (hydroc::SetInitialEnvironment(argc, argv) != 0) {
+        return 1;
+    }
+
+    // JONSWAP sea state with random phases, components spaced as in IrregularWaves::CreateSpectrum()
+    double duration           = 600.0;
+    double frequency_min      = 0.001;
+    double frequency_max      = 1.0;
+    int nf                    = std::ceil((frequency_max - frequency_min) * duration);
+    Eigen::VectorXd freqs_hz  = Eigen::VectorXd::LinSpaced(nf, frequency_min, frequency_max);
+    Eigen::VectorXd densities = JONSWAPSpectrumHz(freqs_hz, 2.0, 8.0, 3.3, false);
+    Eigen::VectorXd widths    = Eigen::VectorXd::Constant(nf, (frequency_max - frequency_min) / (nf - 1));
+    Eigen::VectorXd phases(nf), wavenumbers(nf);
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> dist(0.0, 2 * M_PI);
+    for (int i = 0; i < nf; i++) {
+        phases[i]      = dist(rng);
+        wavenumbers[i] = std::pow(2 * M_PI * freqs_hz[i], 2) / 9.81;
+    }
+
+    double t0     = -20.0;
+    double dt     = 0.01;
+    int num_times = 64001;
+
+    bool ok = true;
+    for (double x : {0.0, 7.5}) {
+        Eigen::Vector3d position(x, 0.0, 0.0);
+        auto eta = GetEtaIrregularTimeSeriesFFT(position, t0, dt, num_times, freqs_hz, densities, widths, phases,
+                                                wavenumbers);
+
+        // direct sum of cosines at a subset of the times
+        double error = 0.0, max_eta = 0.0;
+        for (int n = 0; n < num_times; n += 97) {
+            double t      = t0 + n * dt;
+            double direct = 0.0;
+            for (int i = 0; i < nf; i++) {
+                double amplitude = std::sqrt(2 * densities[i] * widths[i]);
+                direct += amplitude * cos(wavenumbers[i] * x - 2 * M_PI * freqs_hz[i] * t + phases[i]);
+            }
+            error   = std::max(error, std::abs(eta[n] - direct));
+            max_eta = std::max(max_eta, std::abs(direct));
+        }
+        if (error > 1e-9 * max_eta) {
+            std::cerr << "FFT free surface elevation at x = " << x << " differs from the sum of cosines by " << error
+                      << std::endl;
+            ok = false;
+        }
+    }
+
+    // IrregularWaves: direct sums on several threads give the same elevation as on one thread, and as the FFT
+    path DATADIR(hydroc::getDataDir());
+    auto h5fname    = (DATADIR / "sphere" / "hydroData" / "sphere.h5").lexically_normal().generic_string();
+    auto hydro_data = std::make_shared<const HydroData>(H5FileInfo(h5fname, 1).ReadH5Data());
+
+    IrregularWaveParams params;
+    params.num_bodies_          = 1;
+    params.simulation_dt_       = 0.01;
+    params.simulation_duration_ = 100.0;
+    params.wave_height_         = 2.0;
+    params.wave_period_         = 8.0;
+    params.fft_free_surface_    = false;
+
+    std::vector<std::vector<double>> elevations;
+    for (int num_threads : {1, 4}) {
+        params.num_threads_ = num_threads;
+        IrregularWaves wave(params);
+        wave.AddH5Data(hydro_data);
+        elevations.push_back(wave.GetFreeSurfaceElevation());
+    }
+    params.fft_free_surface_ = true;
+    IrregularWaves fft_wave(params);
+    fft_wave.AddH5Data(hydro_data);
+    elevations.push_back(fft_wave.GetFreeSurfaceElevation());
+
+    if (elevations[1] != elevations[0]) {
+        std::cerr << "Free surface elevation depends on the number of threads" << std::endl;
+        ok = false;
+    }
+    double error = 0.0, max_eta = 0.0;
+    for (size_t n = 0; n < elevations[0].size(); n++) {
+        error   = std::max(error, std::abs(elevations[2][n] - elevations[0][n]));
+        max_eta = std::max(max_eta, std::abs(elevations[0][n]));
+    }
+    if (elevations[2].size() != elevations[0].size() || error > 1e-9 * max_eta) {
+        std::cerr << "FFT and direct free surface elevations differ by " << error << std::endl;
+        ok = false;
+    }
+
+    // excitation force with the weighted IRF of the h5 data cache, compared to the per dof trapezoidal convolution
+    // of the IRF with the linearly interpolated free surface elevation
+    auto resampled_irf        = hydro_data->GetResampledExcitationIRF(0, params.simulation_dt_);
+    const auto& irf_time      = *resampled_irf->time;
+    const auto& irf_values    = *resampled_irf->values;
+    Eigen::VectorXd irf_width = GetTrapezoidalWidths(irf_time);
+    const auto& fft_eta       = fft_wave.GetFreeSurfaceElevation();
+    const auto& fft_time      = fft_wave.GetFreeSurfaceTime();
+
+    double convolution_error = 0.0, max_force = 0.0;
+    for (double t = 0.0; t < params.simulation_duration_; t += 0.37) {
+        Eigen::VectorXd force = fft_wave.GetForceAtTime(t);
+        for (int dof = 0; dof < 6; dof++) {
+            double reference = 0.0;
+            for (Eigen::Index j = 0; j < irf_time.size(); j++) {
+                double t_tau = t - irf_time[j];
+                size_t idx   = std::upper_bound(fft_time.begin(), fft_time.end(), t_tau) - fft_time.begin() - 1;
+                idx          = std::min(idx, fft_time.size() - 2);
+                double w2    = (t_tau - fft_time[idx]) / (fft_time[idx + 1] - fft_time[idx]);
+                double eta   = (1.0 - w2) * fft_eta[idx] + w2 * fft_eta[idx + 1];
+                reference += irf_values(dof, j) * eta * irf_width[j];
+            }
+            convolution_error = std::max(convolution_error, std::abs(force[dof] - reference));
+            max_force         = std::max(max_force, std::abs(reference));
+        }
+    }
+    if (resampled_irf->weighted != hydro_data->GetResampledExcitationIRF(0, params.simulation_dt_)->weighted ||
+        convolution_error > 1e-12 * max_force) {
+        std::cerr << "Excitation convolution with the weighted IRF differs by " << convolution_error << " of "
+                  << max_force << std::endl;
+        ok = false;
+    }
+
+    // per body series at a reference position downstream, phase shifted in the synthesis
+    params.eta_reference_positions_ = {Eigen::Vector3d(25.0, 0.0, 0.0)};
+    IrregularWaves shifted_wave(params);
+    shifted_wave.AddH5Data(hydro_data);
+    auto shifted_eta  = shifted_wave.GetFreeSurfaceElevation(0);
+    auto shifted_time = shifted_wave.GetFreeSurfaceTime();
+    error             = 0.0;
+    for (size_t n = 0; n < shifted_time.size(); n += 37) {
+        double direct = shifted_wave.GetElevation(params.eta_reference_positions_[0], shifted_time[n]);
+        error         = std::max(error, std::abs(shifted_eta[n] - direct));
+    }
+    if (shifted_eta.size() != shifted_time.size() || error > 1e-9 * max_eta) {
+        std::cerr << "Free surface elevation at the reference position differs by " << error << std::endl;
+        ok = false;
+    }
+    bool thrown = false;
+    try {
+        params.eta_reference_positions_.push_back(Eigen::Vector3d::Zero());
+        IrregularWaves wrong_wave(params);
+        wrong_wave.AddH5Data(hydro_data);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    if (!thrown) {
+        std::cerr << "More reference positions than bodies were accepted" << std::endl;
+        ok = false;
+    }
+    params.eta_reference_positions_.clear();
+
+    // streamed elevation: same forces as the precomputed series, window bounded over a long simulation
+    params.eta_reference_positions_  = {Eigen::Vector3d(25.0, 0.0, 0.0)};
+    params.streaming_free_surface_   = true;
+    params.streaming_block_duration_ = 20.0;
+    thrown                           = false;
+    try {
+        IrregularWaves wrong_wave(params);
+        wrong_wave.AddH5Data(hydro_data);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    if (!thrown) {
+        std::cerr << "Streamed elevation without an explicit number of frequencies was accepted" << std::endl;
+        ok = false;
+    }
+    // same frequencies as the automatic number of the precomputed series
+    params.nfrequencies_ =
+        std::ceil((params.frequency_max_ - params.frequency_min_) / (1.0 / params.simulation_duration_));
+    IrregularWaves streaming_wave(params);
+    streaming_wave.AddH5Data(hydro_data);
+    double force_error = 0.0;
+    max_force          = 0.0;
+    size_t max_window  = 0;
+    for (double t = 0.0; t < 1000.0; t += 0.37) {
+        double force = streaming_wave.GetForceAtTime(t)[2];
+        max_window   = std::max(max_window, streaming_wave.GetFreeSurfaceTime().size());
+        if (t < params.simulation_duration_) {
+            force_error = std::max(force_error, std::abs(force - shifted_wave.GetForceAtTime(t)[2]));
+            max_force   = std::max(max_force, std::abs(force));
+        }
+    }
+    auto window_eta  = streaming_wave.GetFreeSurfaceElevation(0);
+    auto window_time = streaming_wave.GetFreeSurfaceTime();
+    error            = 0.0;
+    for (size_t n = 0; n < window_time.size(); n += 37) {
+        double direct = streaming_wave.GetElevation(params.eta_reference_positions_[0], window_time[n]);
+        error         = std::max(error, std::abs(window_eta[n] - direct));
+    }
+    if (force_error > 1e-3 * max_force || error > 1e-9 * max_eta || window_time.front() < 800.0 ||
+        max_window * params.simulation_dt_ > 200.0) {
+        std::cerr << "Streamed free surface elevation: force error " << force_error << " of " << max_force
+                  << ", elevation error " << error << ", window " << window_time.front() << " to "
+                  << window_time.back() << ", max window " << max_window << std::endl;
+        ok = false;
+    }
+
+    // ramped in time: the streamed and precomputed series (larger time step) ramp alike, and both give the unramped
+    // force from t = ramp_duration_ on
+    params.ramp_duration_ = 30.0;
+    IrregularWaves ramped_streaming_wave(params);
+    ramped_streaming_wave.AddH5Data(hydro_data);
+    params.streaming_free_surface_ = false;
+    IrregularWaves ramped_wave(params);
+    ramped_wave.AddH5Data(hydro_data);
+    double ramped_error = 0.0, unramped_error = 0.0;
+    for (double t = 0.0; t < 100.0; t += 0.37) {
+        double force = ramped_wave.GetForceAtTime(t)[2];
+        ramped_error = std::max(ramped_error, std::abs(ramped_streaming_wave.GetForceAtTime(t)[2] - force));
+        if (t >= params.ramp_duration_) {
+            unramped_error = std::max(unramped_error, std::abs(force - shifted_wave.GetForceAtTime(t)[2]));
+        }
+    }
+    if (ramped_error > 1e-3 * max_force || unramped_error > 1e-12 * max_force) {
+        std::cerr << "Ramped free surface elevation: streamed force differs by " << ramped_error
+                  << ", force after the ramp differs from the unramped force by " << unramped_error << std::endl;
+        ok = false;
+    }
+    params.ramp_duration_ = 0.0;
+    params.nfrequencies_  = 0;
+    params.eta_reference_positions_.clear();
+
+    // excitation force precomputed by FFT convolution, from the spectrum and from the same elevation in an eta file
+    auto eta_file = (std::filesystem::temp_directory_path() / "irregular_wave_t01_eta.txt").generic_string();
+    WriteEtaFile(eta_file, fft_wave.GetFreeSurfaceTime(), elevations[2]);
+    params.precompute_excitation_force_ = true;
+    IrregularWaves precomputed_wave(params);
+    precomputed_wave.AddH5Data(hydro_data);
+    IrregularWaveParams file_params = params;
+    file_params.eta_file_path_      = eta_file;
+    IrregularWaves file_wave(file_params);
+    file_wave.AddH5Data(hydro_data);
+    params.precompute_excitation_force_ = false;
+    std::filesystem::remove(eta_file);
+
+    double precomputed_error = 0.0, file_error = 0.0;
+    max_force                = 0.0;
+    for (double t = 0.0; t < params.simulation_duration_; t += 0.37) {
+        Eigen::VectorXd force = fft_wave.GetForceAtTime(t);
+        precomputed_error     = std::max(precomputed_error, (precomputed_wave.GetForceAtTime(t) - force).norm());
+        file_error            = std::max(file_error, (file_wave.GetForceAtTime(t) - force).norm());
+        max_force             = std::max(max_force, force.norm());
+    }
+    if (precomputed_error > 1e-3 * max_force || file_error > 1e-3 * max_force) {
+        std::cerr << "Precomputed excitation force differs from the convolution by " << precomputed_error
+                  << " (spectrum) and " << file_error << " (eta file) of " << max_force << std::endl;
+        ok = false;
+    }
+
+    // eta files: text, binary and HDF5 read back the same samples, and an imported elevation gives the same
+    // convolution force as the spectrum it was written from
+    auto eta_time = fft_wave.GetFreeSurfaceTime();
+    for (const char* extension : {".txt", ".bin", ".h5"}) {
+        auto file_name = (std::filesystem::temp_directory_path() / (std::string("irregular_wave_t01_eta") + extension))
+                             .generic_string();
+        WriteEtaFile(file_name, eta_time, elevations[2]);
+        std::vector<double> read_time, read_eta;
+        ReadEtaFile(file_name, read_time, read_eta);
+        if (read_time != eta_time || read_eta != elevations[2]) {
+            std::cerr << "Eta file " << extension << " does not read back the written samples" << std::endl;
+            ok = false;
+        }
+        if (std::string(extension) == ".bin") {
+            file_params.precompute_excitation_force_ = false;
+            file_params.eta_file_path_               = file_name;
+            IrregularWaves imported_wave(file_params);
+            imported_wave.AddH5Data(hydro_data);
+            double imported_error = 0.0;
+            for (double t : {0.0, 31.4, 99.0}) {
+                imported_error =
+                    std::max(imported_error, (imported_wave.GetForceAtTime(t) - fft_wave.GetForceAtTime(t)).norm());
+            }
+            if (imported_error > 1e-9 * max_force) {
+                std::cerr << "Imported elevation gives a different excitation force, by " << imported_error
+                          << std::endl;
+                ok = false;
+            }
+        }
+        std::filesystem::remove(file_name);
+    }
+    {
+        std::ofstream bad_output(eta_file);
+        bad_output << "0.0 : 1.0\n0.1 ; 2.0\n";
+    }
+    thrown = false;
+    try {
+        std::vector<double> read_time, read_eta;
+        ReadEtaFile(eta_file, read_time, read_eta);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    std::filesystem::remove(eta_file);
+    if (!thrown) {
+        std::cerr << "Malformed eta file was accepted" << std::endl;
+        ok = false;
+    }
+
+    // vectorized sine and cosine used by the kinematics
+    Eigen::ArrayXd angles = Eigen::ArrayXd::LinSpaced(100001, -5e4, 5e4) + 0.3;
+    Eigen::ArrayXd sines, cosines;
+    hydroc::SinCos(angles, sines, cosines);
+    double sincos_error = std::max((sines - angles.sin()).abs().maxCoeff(), (cosines - angles.cos()).abs().maxCoeff());
+    if (sincos_error > 1e-15) {
+        std::cerr << "SinCos differs from std::sin/std::cos by " << sincos_error << std::endl;
+        ok = false;
+    }
+
+    // at the mean water level (no stretching), the vertical velocity and acceleration are the time derivatives of
+    // the elevation
+    params.wave_stretching_ = false;
+    IrregularWaves kinematics_wave(params);
+    kinematics_wave.AddH5Data(hydro_data);
+    double h = 1e-4;
+    for (double t : {3.0, 41.7, 95.2}) {
+        Eigen::Vector3d position(2.0, 0.0, 0.0);
+        double eta_dot =
+            (kinematics_wave.GetElevation(position, t + h) - kinematics_wave.GetElevation(position, t - h)) / (2 * h);
+        double w_dot = (kinematics_wave.GetVelocity(position, t + h).z() -
+                        kinematics_wave.GetVelocity(position, t - h).z()) /
+                       (2 * h);
+        double velocity     = kinematics_wave.GetVelocity(position, t).z();
+        double acceleration = kinematics_wave.GetAcceleration(position, t).z();
+        if (std::abs(velocity - eta_dot) > 1e-6 * (1.0 + std::abs(velocity)) ||
+            std::abs(acceleration - w_dot) > 1e-6 * (1.0 + std::abs(acceleration))) {
+            std::cerr << "Irregular wave kinematics at t = " << t << " do not match the elevation: " << velocity << " "
+                      << eta_dot << " " << acceleration << " " << w_dot << std::endl;
+            ok = false;
+        }
+    }
+
+    std::cout << "End" << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,174 @@
+#include <hydroc/h5fileinfo.h>
+#include <hydroc/helper.h>
+#include <hydroc/wave_types.h>
+
+#include <cmath>
+#include <filesystem>  // C++17
+#include <iostream>
+#include <memory>
+
+using std::filesystem::path;
+
+int main(int argc, char* argv[]) {
+    if (hydroc::SetInitialEnvironment(argc, argv) != 0) {
+        return 1;
+    }
+
+    path DATADIR(hydroc::getDataDir());
+
+    auto h5fname = (DATADIR / "sphere" / "hydroData" / "sphere.h5").lexically_normal().generic_string();
+
+    auto hydro_data = std::make_shared<const HydroData>(H5FileInfo(h5fname, 1).ReadH5Data());
+
+    // bichromatic wave, compared to the sum of two regular waves
+    Eigen::VectorXd omegas(2), amplitudes(2);
+    omegas << 1.047197551, 1.427996661;
+    amplitudes << 0.706, 0.25;
+
+    PolychromaticWave wave(1);
+    wave.component_omegas_     = omegas;
+    wave.component_amplitudes_ = amplitudes;
+    wave.AddH5Data(hydro_data);
+    wave.Initialize();
+
+    std::vector<std::shared_ptr<RegularWave>> components;
+    for (int c = 0; c < omegas.size(); c++) {
+        auto reg                        = std::make_shared<RegularWave>(1);
+        reg->regular_wave_amplitude_    = amplitudes[c];
+        reg->regular_wave_omega_        = omegas[c];
+        reg->excitation_reanchor_steps_ = 0;
+        reg->AddH5Data(hydro_data);
+        reg->Initialize();
+        components.push_back(reg);
+    }
+
+    bool ok = true;
+
+    double force_error = 0.0, elevation_error = 0.0, kinematics_error = 0.0;
+    Eigen::Vector3d position(3.0, 0.0, -2.0);
+    for (int step = 0; step < 500; step++) {
+        double t = 0.13 * step;
+
+        Eigen::VectorXd force = Eigen::VectorXd::Zero(6);
+        double elevation      = 0.0;
+        Eigen::Vector3d velocity(0.0, 0.0, 0.0), acceleration(0.0, 0.0, 0.0);
+        for (auto& reg : components) {
+            force += reg->GetForceAtTime(t);
+            elevation += reg->GetElevation(position, t);
+            velocity += reg->GetVelocity(position, t);
+            acceleration += reg->GetAcceleration(position, t);
+        }
+
+        force_error     = std::max(force_error, (wave.GetForceAtTime(t) - force).norm() / force.norm());
+        elevation_error = std::max(elevation_error, std::abs(wave.GetElevation(position, t) - elevation));
+        kinematics_error =
+            std::max(kinematics_error, (wave.GetVelocity(position, t) - velocity).norm() +
+                                           (wave.GetAcceleration(position, t) - acceleration).norm());
+    }
+    if (force_error > 1e-10 || elevation_error > 1e-12 || kinematics_error > 1e-12) {
+        std::cerr << "Polychromatic wave differs from the sum of regular waves: force " << force_error
+                  << ", elevation " << elevation_error << ", kinematics " << kinematics_error << std::endl;
+        ok = false;
+    }
+
+    // batched kinematics at several points, compared to the batched kinematics of the regular waves
+    Eigen::MatrixX3d positions(4, 3);
+    positions << 3.0, 0.0, -2.0, -10.0, 4.0, -0.5, 25.0, -3.0, -15.0, 0.0, 0.0, 0.0;
+    double batch_error = 0.0;
+    for (int step = 0; step < 50; step++) {
+        double t = 0.37 * step;
+
+        Eigen::VectorXd elevations = Eigen::VectorXd::Zero(positions.rows()), reg_elevations;
+        Eigen::MatrixX3d velocities = Eigen::MatrixX3d::Zero(positions.rows(), 3), reg_velocities;
+        Eigen::MatrixX3d accelerations = Eigen::MatrixX3d::Zero(positions.rows(), 3), reg_accelerations;
+        for (auto& reg : components) {
+            reg->GetElevations(positions, t, reg_elevations);
+            reg->GetVelocities(positions, t, reg_velocities);
+            reg->GetAccelerations(positions, t, reg_accelerations);
+            elevations += reg_elevations;
+            velocities += reg_velocities;
+            accelerations += reg_accelerations;
+        }
+
+        Eigen::VectorXd wave_elevations;
+        Eigen::MatrixX3d wave_velocities, wave_accelerations;
+        wave.GetElevations(positions, t, wave_elevations);
+        wave.GetVelocities(positions, t, wave_velocities);
+        wave.GetAccelerations(positions, t, wave_accelerations);
+        batch_error = std::max(batch_error, (wave_elevations - elevations).cwiseAbs().maxCoeff() +
+                                                (wave_velocities - velocities).cwiseAbs().maxCoeff() +
+                                                (wave_accelerations - accelerations).cwiseAbs().maxCoeff());
+    }
+    if (batch_error > 1e-12) {
+        std::cerr << "Batched polychromatic kinematics differ from the sum of regular waves: " << batch_error
+                  << std::endl;
+        ok = false;
+    }
+
+    // heading 90 with the excitation of heading 0 at all headings: the same force, the kinematics of heading 0 with x
+    // and y swapped
+    HydroData circle_data = *hydro_data;
+
+    circle_data.GetSimulationInfo().wave_headings = Eigen::Vector4d(0.0, 90.0, 180.0, 270.0);
+    for (auto& reg : circle_data.GetRegularWaveInfos()) {
+        Eigen::array<Eigen::Index, 3> four_headings{1, 4, 1};
+        Eigen::Tensor<double, 3> mag   = reg.excitation_mag_matrix.broadcast(four_headings);
+        Eigen::Tensor<double, 3> phase = reg.excitation_phase_matrix.broadcast(four_headings);
+        reg.excitation_mag_matrix      = mag;
+        reg.excitation_phase_matrix    = phase;
+    }
+    auto circle = std::make_shared<const HydroData>(std::move(circle_data));
+    PolychromaticWave wave_x(1), wave_y(1);
+    for (auto* rotated : {&wave_x, &wave_y}) {
+        rotated->component_omegas_     = omegas;
+        rotated->component_amplitudes_ = amplitudes;
+        rotated->AddH5Data(circle);
+    }
+    wave_y.wave_heading_ = 90.0;
+    wave_x.Initialize();
+    wave_y.Initialize();
+    Eigen::MatrixX3d swapped = positions;
+    swapped.col(0)           = positions.col(1);
+    swapped.col(1)           = positions.col(0);
+    double heading_error     = 0.0;
+    for (double t : {0.0, 3.1, 17.4}) {
+        Eigen::VectorXd eta_x, eta_y;
+        Eigen::MatrixX3d velocity_x, velocity_y, acceleration_x, acceleration_y;
+        wave_x.GetElevations(swapped, t, eta_x);
+        wave_x.GetVelocities(swapped, t, velocity_x);
+        wave_x.GetAccelerations(swapped, t, acceleration_x);
+        wave_y.GetElevations(positions, t, eta_y);
+        wave_y.GetVelocities(positions, t, velocity_y);
+        wave_y.GetAccelerations(positions, t, acceleration_y);
+        velocity_x.col(0).swap(velocity_x.col(1));
+        acceleration_x.col(0).swap(acceleration_x.col(1));
+        heading_error = std::max(heading_error, (eta_y - eta_x).cwiseAbs().maxCoeff() +
+                                                    (velocity_y - velocity_x).cwiseAbs().maxCoeff() +
+                                                    (acceleration_y - acceleration_x).cwiseAbs().maxCoeff() +
+                                                    (wave_y.GetForceAtTime(t) - wave_x.GetForceAtTime(t)).norm());
+    }
+    if (heading_error > 1e-9) {
+        std::cerr << "Kinematics of heading 90 are not the kinematics of heading 0 rotated: " << heading_error
+                  << std::endl;
+        ok = false;
+    }
+
+    // mismatched component vectors are rejected
+    bool thrown = false;
+    try {
+        PolychromaticWave bad_wave(1);
+        bad_wave.component_omegas_     = omegas;
+        bad_wave.component_amplitudes_ = Eigen::VectorXd::Ones(3);
+        bad_wave.AddH5Data(hydro_data);
+        bad_wave.Initialize();
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    if (!thrown) {
+        std::cerr << "Mismatched component vectors were accepted" << std::endl;
+        ok = false;
+    }
+
+    std::cout << "End" << std::endl;
+    return ok ? 0 : 1;
+}
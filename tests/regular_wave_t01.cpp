@@ -0,0 +1,188 @@
+#include <hydroc/h5fileinfo.h>
+#include <hydroc/helper.h>
+#include <hydroc/wave_types.h>
+
+#include <cmath>
+#include <filesystem>  // C++17
+#include <iostream>
+#include <memory>
+#include <utility>
+
+using std::filesystem::path;
+
+int main(int argc, char* argv[]) {
+    if (hydroc::SetInitialEnvironment(argc, argv) != 0) {
+        return 1;
+    }
+
+    path DATADIR(hydroc::getDataDir());
+
+    auto h5fname = (DATADIR / "sphere" / "hydroData" / "sphere.h5").lexically_normal().generic_string();
+
+    auto hydro_data = std::make_shared<const HydroData>(H5FileInfo(h5fname, 1).ReadH5Data());
+
+    RegularWave wave(1);
+    wave.regular_wave_amplitude_ = 0.706;
+    wave.regular_wave_omega_     = 1.047197551;
+    wave.AddH5Data(hydro_data);
+    wave.Initialize();
+
+    // excitation at the wave frequency, linearly interpolated between the h5 frequencies, evaluated directly with cos
+    const auto& reg = hydro_data->GetRegularWaveInfos()[0];
+    int k           = 0;
+    while (reg.freq_list[k + 1] <= wave.regular_wave_omega_) {
+        k++;
+    }
+    double w = (wave.regular_wave_omega_ - reg.freq_list[k]) / (reg.freq_list[k + 1] - reg.freq_list[k]);
+    Eigen::VectorXd mag(6), phase(6);
+    for (int dof = 0; dof < 6; dof++) {
+        mag[dof]   = (1 - w) * reg.excitation_mag_matrix(dof, 0, k) + w * reg.excitation_mag_matrix(dof, 0, k + 1);
+        phase[dof] = (1 - w) * reg.excitation_phase_matrix(dof, 0, k) + w * reg.excitation_phase_matrix(dof, 0, k + 1);
+    }
+    double scale = wave.regular_wave_amplitude_ * mag.maxCoeff();
+
+    auto max_error = [&](double t) {
+        Eigen::VectorXd f = wave.GetForceAtTime(t);
+        double error      = 0.0;
+        for (int dof = 0; dof < 6; dof++) {
+            double expected =
+                mag[dof] * wave.regular_wave_amplitude_ * cos(wave.regular_wave_omega_ * t + phase[dof]);
+            error = std::max(error, std::abs(f[dof] - expected));
+        }
+        return error / scale;
+    };
+
+    bool ok = true;
+
+    // constant time step as accumulated by the solver, several calls per step
+    double error = 0.0;
+    double t     = 0.0;
+    for (int step = 0; step < 60000; step++) {
+        error = std::max(error, max_error(t));
+        error = std::max(error, max_error(t));
+        t += 0.01;
+    }
+    if (error > 1e-9) {
+        std::cerr << "Constant time step force error " << error << std::endl;
+        ok = false;
+    }
+
+    // varying time steps
+    error = 0.0;
+    for (int step = 0; step < 1000; step++) {
+        error = std::max(error, max_error(t));
+        t += 0.005 * (1 + step % 3);
+    }
+    if (error > 1e-10) {
+        std::cerr << "Variable time step force error " << error << std::endl;
+        ok = false;
+    }
+
+    // headings are wrapped into the range of the h5 file (a single heading for the sphere), others are rejected
+    double heading = hydro_data->GetSimulationInfo().wave_headings[0];
+    RegularWave wrapped_wave(1);
+    wrapped_wave.regular_wave_amplitude_ = wave.regular_wave_amplitude_;
+    wrapped_wave.regular_wave_omega_     = wave.regular_wave_omega_;
+    wrapped_wave.regular_wave_heading_   = heading + 360.0;
+    wrapped_wave.AddH5Data(hydro_data);
+    wrapped_wave.Initialize();
+    if ((wrapped_wave.GetForceAtTime(1.0) - wave.GetForceAtTime(1.0)).norm() != 0.0) {
+        std::cerr << "Force for heading " << heading + 360.0 << " differs from heading " << heading << std::endl;
+        ok = false;
+    }
+    bool thrown = false;
+    try {
+        RegularWave other_heading(1);
+        other_heading.regular_wave_omega_   = wave.regular_wave_omega_;
+        other_heading.regular_wave_heading_ = heading + 30.0;
+        other_heading.AddH5Data(hydro_data);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    if (!thrown) {
+        std::cerr << "Heading outside of the h5 headings was accepted" << std::endl;
+        ok = false;
+    }
+
+    // headings around the whole circle are interpolated across 360 degrees, partial circles are not
+    Eigen::VectorXd circle = Eigen::VectorXd::LinSpaced(36, 0.0, 350.0);
+    HeadingInterp seam     = GetHeadingInterp(circle, 355.0);
+    HeadingInterp negative = GetHeadingInterp(circle, -5.0);
+    if (seam.index != 35 || seam.upper_index != 0 || std::abs(seam.weight - 0.5) > 1e-12 ||
+        negative.index != seam.index || negative.upper_index != seam.upper_index || negative.weight != seam.weight) {
+        std::cerr << "Heading 355 is not interpolated between the headings 350 and 0" << std::endl;
+        ok = false;
+    }
+    thrown = false;
+    try {
+        GetHeadingInterp(Eigen::Vector3d(0.0, 90.0, 180.0), 270.0);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    if (!thrown) {
+        std::cerr << "Heading 270 was interpolated between the headings 180 and 0" << std::endl;
+        ok = false;
+    }
+
+    // phases on both sides of +/- pi are interpolated along the shortest arc
+    HydroData::RegularWaveInfo straddling;
+    straddling.excitation_mag_matrix.resize(6, 2, 1);
+    straddling.excitation_mag_matrix.setConstant(1.0);
+    straddling.excitation_phase_matrix.resize(6, 2, 1);
+    straddling.excitation_phase_matrix.setConstant(3.0);
+    straddling.excitation_phase_matrix(2, 1, 0) = -3.0;
+    double straddling_mag, straddling_phase;
+    HeadingInterp middle = GetHeadingInterp(Eigen::Vector2d(0.0, 10.0), 5.0);
+    InterpolateExcitation(straddling, 2, middle, {0, 0.0}, straddling_mag, straddling_phase);
+    if (straddling_mag != 1.0 || std::abs(std::cos(straddling_phase) + 1.0) > 1e-12) {
+        std::cerr << "Excitation phase between 3 and -3 is " << straddling_phase << ", expected pi" << std::endl;
+        ok = false;
+    }
+
+    // the kinematics travel along the heading: heading 90 (with the excitation of heading 0 at all headings) is
+    // heading 0 with x and y swapped
+    HydroData circle_data = *hydro_data;
+
+    circle_data.GetSimulationInfo().wave_headings = Eigen::Vector4d(0.0, 90.0, 180.0, 270.0);
+    for (auto& info : circle_data.GetRegularWaveInfos()) {
+        Eigen::array<Eigen::Index, 3> four_headings{1, 4, 1};
+        Eigen::Tensor<double, 3> mag_headings   = info.excitation_mag_matrix.broadcast(four_headings);
+        Eigen::Tensor<double, 3> phase_headings = info.excitation_phase_matrix.broadcast(four_headings);
+        info.excitation_mag_matrix              = mag_headings;
+        info.excitation_phase_matrix            = phase_headings;
+    }
+    auto circle_hydro_data = std::make_shared<const HydroData>(std::move(circle_data));
+    RegularWave wave_x(1), wave_y(1);
+    for (auto* rotated : {&wave_x, &wave_y}) {
+        rotated->regular_wave_amplitude_ = wave.regular_wave_amplitude_;
+        rotated->regular_wave_omega_     = wave.regular_wave_omega_;
+    }
+    wave_y.regular_wave_heading_ = 90.0;
+    for (auto* rotated : {&wave_x, &wave_y}) {
+        rotated->AddH5Data(circle_hydro_data);
+        rotated->Initialize();
+    }
+    double heading_error = 0.0;
+    for (double time : {0.0, 2.3, 11.9}) {
+        Eigen::Vector3d point(4.0, -7.0, -3.0), swapped(-7.0, 4.0, -3.0);
+        Eigen::Vector3d velocity_x     = wave_x.GetVelocity(swapped, time);
+        Eigen::Vector3d velocity_y     = wave_y.GetVelocity(point, time);
+        Eigen::Vector3d acceleration_x = wave_x.GetAcceleration(swapped, time);
+        Eigen::Vector3d acceleration_y = wave_y.GetAcceleration(point, time);
+        std::swap(velocity_x[0], velocity_x[1]);
+        std::swap(acceleration_x[0], acceleration_x[1]);
+        heading_error = std::max(heading_error, std::abs(wave_y.GetElevation(point, time) -
+                                                         wave_x.GetElevation(swapped, time)) +
+                                                    (velocity_y - velocity_x).norm() +
+                                                    (acceleration_y - acceleration_x).norm() +
+                                                    (wave_y.GetForceAtTime(time) - wave_x.GetForceAtTime(time)).norm());
+    }
+    if (heading_error > 1e-9 || wave_y.GetVelocity(Eigen::Vector3d(0.0, 1.0, -1.0), 0.3)[1] == 0.0) {
+        std::cerr << "Kinematics of heading 90 are not the kinematics of heading 0 rotated: " << heading_error
+                  << std::endl;
+        ok = false;
+    }
+
+    std::cout << "End" << std::endl;
+    return ok ? 0 : 1;
+}
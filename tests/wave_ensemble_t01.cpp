@@ -0,0 +1,129 @@
+#include <hydroc/h5fileinfo.h>
+#include <hydroc/helper.h>
+#include <hydroc/wave_ensemble.h>
+#include <hydroc/wave_types.h>
+
+#include <filesystem>  // C++17
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+using std::filesystem::path;
+
+int main(int argc, char* argv[]) {
+    if (hydroc::SetInitialEnvironment(argc, argv) != 0) {
+        return 1;
+    }
+
+    path DATADIR(hydroc::getDataDir());
+
+    auto h5fname = (DATADIR / "sphere" / "hydroData" / "sphere.h5").lexically_normal().generic_string();
+
+    auto hydro_data = std::make_shared<const HydroData>(H5FileInfo(h5fname, 1).ReadH5Data());
+
+    IrregularWaveParams params;
+    params.num_bodies_          = 1;
+    params.simulation_dt_       = 0.01;
+    params.simulation_duration_ = 200.0;
+    params.ramp_duration_       = 20.0;
+    params.wave_height_         = 2.0;
+    params.wave_period_         = 8.0;
+    params.num_threads_         = 3;
+    params.diagnostics_         = nullptr;
+
+    bool ok = true;
+
+    IrregularWaveEnsemble ensemble(params, hydro_data);
+    std::vector<int> seeds                             = {1, 7, 42, 7};
+    std::vector<IrregularWaveRealization> realizations = ensemble.Generate(seeds);
+    Eigen::VectorXd times                              = ensemble.GetExcitationTimes();
+    if (realizations.size() != seeds.size() || times.size() != 20001) {
+        std::cerr << "Ensemble generated " << realizations.size() << " realizations with " << times.size()
+                  << " excitation times" << std::endl;
+        return 1;
+    }
+
+    // each realization is the wave set up with its seed, the excitation force is the precomputed one
+    for (size_t i = 0; i < seeds.size(); i++) {
+        const auto& realization = realizations[i];
+        params.seed_            = seeds[i];
+        IrregularWaves wave(params);
+        wave.AddH5Data(hydro_data);
+        params.precompute_excitation_force_ = true;
+        IrregularWaves precomputed(params);
+        precomputed.AddH5Data(hydro_data);
+        params.precompute_excitation_force_ = false;
+        if (realization.seed != seeds[i] ||
+            realization.waves->GetFreeSurfaceElevation() != wave.GetFreeSurfaceElevation() ||
+            realization.waves->GetFreeSurfaceTime() != wave.GetFreeSurfaceTime()) {
+            std::cerr << "Free surface elevation of seed " << seeds[i] << " differs from its wave" << std::endl;
+            ok = false;
+        }
+        for (Eigen::Index n = 0; n < times.size(); n += 97) {
+            if (realization.excitation_force.col(n) != precomputed.GetForceAtTime(times[n]) ||
+                realization.waves->GetForceAtTime(times[n]) != wave.GetForceAtTime(times[n])) {
+                std::cerr << "Excitation force of seed " << seeds[i] << " at " << times[n] << " differs from its wave"
+                          << std::endl;
+                ok = false;
+                break;
+            }
+        }
+    }
+
+    // a seed gives the same realization whatever the other seeds and threads, different seeds differ
+    if (realizations[1].excitation_force != realizations[3].excitation_force ||
+        realizations[0].waves->GetFreeSurfaceElevation() == realizations[1].waves->GetFreeSurfaceElevation()) {
+        std::cerr << "Realizations do not follow their seeds" << std::endl;
+        ok = false;
+    }
+    params.num_threads_ = 1;
+    IrregularWaveEnsemble serial_ensemble(params, hydro_data);
+    auto serial = serial_ensemble.Generate({7}, false);
+    if (serial[0].waves->GetFreeSurfaceElevation() != realizations[1].waves->GetFreeSurfaceElevation() ||
+        serial[0].excitation_force.size() != 0) {
+        std::cerr << "Serial ensemble differs from the parallel ensemble" << std::endl;
+        ok = false;
+    }
+
+    // realizations of a wave set up directly
+    params.seed_ = 1;
+    IrregularWaves wave(params);
+    wave.AddH5Data(hydro_data);
+    if (wave.CreateRealization(42)->GetFreeSurfaceElevation() != realizations[2].waves->GetFreeSurfaceElevation()) {
+        std::cerr << "CreateRealization differs from the ensemble" << std::endl;
+        ok = false;
+    }
+
+    // the force of a streamed elevation is not precomputed
+    bool thrown                    = false;
+    params.streaming_free_surface_ = true;
+    params.nfrequencies_           = 200;
+    IrregularWaveEnsemble streaming_ensemble(params, hydro_data);
+    try {
+        streaming_ensemble.Generate({1});
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    if (!thrown || streaming_ensemble.Generate({1}, false)[0].waves->GetForceAtTime(10.0).size() != 6) {
+        std::cerr << "Ensemble excitation of a streamed elevation was not rejected" << std::endl;
+        ok = false;
+    }
+    params.streaming_free_surface_ = false;
+
+    // an eta file has no phases to draw
+    params.eta_file_path_ = "eta.txt";
+    thrown                = false;
+    try {
+        IrregularWaveEnsemble file_ensemble(params, hydro_data);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    if (!thrown) {
+        std::cerr << "Ensemble of an eta file was accepted" << std::endl;
+        ok = false;
+    }
+
+    std::cout << "End" << std::endl;
+    return ok ? 0 : 1;
+}
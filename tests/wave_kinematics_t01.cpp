@@ -0,0 +1,118 @@
+#include <hydroc/h5fileinfo.h>
+#include <hydroc/helper.h>
+#include <hydroc/wave_types.h>
+
+#include <cmath>
+#include <filesystem>  // C++17
+#include <iostream>
+#include <memory>
+
+using std::filesystem::path;
+
+// largest difference between the fused kinematics of a wave and the separate elevation, velocity and acceleration
+double CompareFusedKinematics(WaveBase& wave, const Eigen::MatrixX3d& positions, double time) {
+    double error = 0.0;
+    for (Eigen::Index p = 0; p < positions.rows(); p++) {
+        Eigen::Vector3d position  = positions.row(p).transpose();
+        WaveKinematics kinematics = wave.GetKinematics(position, time);
+        error = std::max(error, std::abs(kinematics.elevation - wave.GetElevation(position, time)));
+        error = std::max(error, (kinematics.velocity - wave.GetVelocity(position, time)).cwiseAbs().maxCoeff());
+        error = std::max(error, (kinematics.acceleration - wave.GetAcceleration(position, time)).cwiseAbs().maxCoeff());
+    }
+    return error;
+}
+
+// largest difference between the batched kinematics of a wave and one call per point
+double CompareBatchedKinematics(WaveBase& wave, const Eigen::MatrixX3d& positions, double time) {
+    Eigen::VectorXd elevations;
+    Eigen::MatrixX3d velocities, accelerations;
+    wave.GetElevations(positions, time, elevations);
+    wave.GetVelocities(positions, time, velocities);
+    wave.GetAccelerations(positions, time, accelerations);
+
+    double error = 0.0;
+    for (Eigen::Index p = 0; p < positions.rows(); p++) {
+        Eigen::Vector3d position     = positions.row(p).transpose();
+        Eigen::Vector3d velocity     = wave.GetVelocity(position, time);
+        Eigen::Vector3d acceleration = wave.GetAcceleration(position, time);
+        error = std::max(error, std::abs(elevations[p] - wave.GetElevation(position, time)));
+        error = std::max(error, (velocities.row(p).transpose() - velocity).cwiseAbs().maxCoeff());
+        error = std::max(error, (accelerations.row(p).transpose() - acceleration).cwiseAbs().maxCoeff());
+    }
+    return error;
+}
+
+int main(int argc, char* argv[]) {
+    if (hydroc::SetInitialEnvironment(argc, argv) != 0) {
+        return 1;
+    }
+
+    path DATADIR(hydroc::getDataDir());
+
+    auto h5fname = (DATADIR / "sphere" / "hydroData" / "sphere.h5").lexically_normal().generic_string();
+
+    auto hydro_data = std::make_shared<const HydroData>(H5FileInfo(h5fname, 1).ReadH5Data());
+
+    // points along a vertical line and along the wave direction, above and below the mean water level
+    int num_points = 200;
+    Eigen::MatrixX3d positions(num_points, 3);
+    for (int p = 0; p < num_points; p++) {
+        positions(p, 0) = p % 2 == 0 ? 0.0 : 0.37 * p;
+        positions(p, 1) = 1.5;
+        positions(p, 2) = 0.5 - 0.6 * p;
+    }
+
+    bool ok = true;
+
+    RegularWave regular(1);
+    regular.regular_wave_amplitude_ = 0.706;
+    regular.regular_wave_omega_     = 1.047197551;
+    regular.AddH5Data(hydro_data);
+    regular.Initialize();
+    for (double t : {0.0, 12.3, 600.1}) {
+        double error = CompareBatchedKinematics(regular, positions, t);
+        if (error > 1e-12) {
+            std::cerr << "Regular wave batched kinematics at t = " << t << " differ by " << error << std::endl;
+            ok = false;
+        }
+    }
+
+    IrregularWaveParams params;
+    params.num_bodies_          = 1;
+    params.simulation_dt_       = 0.01;
+    params.simulation_duration_ = 100.0;
+    params.wave_height_         = 2.0;
+    params.wave_period_         = 8.0;
+    for (bool stretching : {false, true}) {
+        params.wave_stretching_ = stretching;
+        IrregularWaves irregular(params);
+        irregular.AddH5Data(hydro_data);
+        for (double t : {0.0, 12.3, 95.1}) {
+            double error = CompareBatchedKinematics(irregular, positions, t);
+            if (error > 1e-12) {
+                std::cerr << "Irregular wave batched kinematics at t = " << t << " differ by " << error << std::endl;
+                ok = false;
+            }
+            error = CompareFusedKinematics(irregular, positions, t);
+            if (error > 1e-12) {
+                std::cerr << "Irregular wave fused kinematics at t = " << t << " differ by " << error << std::endl;
+                ok = false;
+            }
+        }
+    }
+
+    // default implementations, one call per point and quantity
+    PolychromaticWave polychromatic(1);
+    polychromatic.component_omegas_     = Eigen::Vector2d(1.047197551, 1.427996661);
+    polychromatic.component_amplitudes_ = Eigen::Vector2d(0.706, 0.25);
+    polychromatic.AddH5Data(hydro_data);
+    polychromatic.Initialize();
+    if (CompareBatchedKinematics(polychromatic, positions, 7.0) != 0.0 ||
+        CompareFusedKinematics(polychromatic, positions, 7.0) != 0.0) {
+        std::cerr << "Polychromatic wave batched kinematics differ" << std::endl;
+        ok = false;
+    }
+
+    std::cout << "End" << std::endl;
+    return ok ? 0 : 1;
+}